@@ -36,6 +36,8 @@ use strict;
 use Carp::Assert;
 
 use Bi::Utility qw(find);
+use Bi::Model::Var;
+use Bi::Expression::IntegerLiteral;
 
 =head1 PARAMETERS
 
@@ -53,12 +55,21 @@ The classic order 4 Runge-Kutta with fixed step size.
 
 =item C<'RK5(4)'>
 
-An order 5(4) Dormand-Prince with adaptive step size.
+An order 5(4) Dormand-Prince with adaptive step size. The step size is
+carried over from one output or observation time to the next, rather than
+starting again from C<h>.
 
 =item C<'RK4(3)'>
 
 An order 4(3) low-storage Runge-Kutta with adaptive step size.
 
+=item C<'ROS2(3)'>
+
+An order 2(3) Rosenbrock with adaptive step size, for stiff systems. This
+requires the Jacobian of the system, which is derived symbolically from the
+differential equations, so that these may not use the ternary operator
+C<?:>.
+
 =back
 
 =item C<h> (position 1, default 1.0)
@@ -106,7 +117,8 @@ sub validate {
     $self->process_args($BLOCK_ARGS);
     
     my $alg = $self->get_named_arg('alg')->eval_const;
-    if ($alg ne 'RK4' && $alg ne 'RK5(4)' && $alg ne 'RK4(3)') {
+    if ($alg ne 'RK4' && $alg ne 'RK5(4)' && $alg ne 'RK4(3)' &&
+        $alg ne 'ROS2(3)') {
         die("unrecognised value '$alg' for argument 'alg' of block 'ode'\n");
     }
     
@@ -114,9 +126,83 @@ sub validate {
         if ($action->get_name ne 'ode_') {
             die("an 'ode' block may only contain ordinary differential equation actions\n");
         }
+        if ($self->is_stiff) {
+            eval { $action->jacobian };
+            if ($@) {
+                die("cannot differentiate equation for '" .
+                    $action->get_left->get_var->get_name .
+                    "' in 'ode' block with alg = '$alg'\n");
+            }
+        }
     }
 }
 
+=head1 METHODS
+
+=over 4
+
+=item B<is_stiff>
+
+Does the block use an integrator for stiff systems, requiring a Jacobian?
+
+=cut
+sub is_stiff {
+    my $self = shift;
+    return $self->get_named_arg('alg')->eval_const eq 'ROS2(3)';
+}
+
+=item B<carries_step>
+
+Does the block carry the step size of its integrator from one call to the
+next? This is the case for C<'RK5(4)'>, where the step size would otherwise
+be reset to C<h> at every output and observation time.
+
+=cut
+sub carries_step {
+    my $self = shift;
+    return $self->get_named_arg('alg')->eval_const eq 'RK5(4)';
+}
+
+=item B<add_step_vars>(I<model>)
+
+Add to I<model> hidden auxiliary state variables in which to carry the step
+size of the integrator from one call to the next, along with the time at
+which that step size applies. Each trajectory has its own, so that they are
+copied along with the trajectory on resampling.
+
+=cut
+sub add_step_vars {
+    my $self = shift;
+    my $model = shift;
+
+    my @vars;
+    foreach my $i (1..2) {
+        my $var = new Bi::Model::Var('state_aux_', undef, [], [], {
+            'has_input' => new Bi::Expression::IntegerLiteral(0),
+            'has_output' => new Bi::Expression::IntegerLiteral(0)
+        });
+        $model->push_var($var);
+        push(@vars, $var);
+    }
+    $self->{_step_vars} = \@vars;
+}
+
+=item B<get_step_vars>
+
+Get the variables added by B<add_step_vars>, as an array ref of the step
+size variable followed by the time variable, or an empty array ref if there
+are none.
+
+=cut
+sub get_step_vars {
+    my $self = shift;
+    return (defined $self->{_step_vars}) ? $self->{_step_vars} : [];
+}
+
+=back
+
+=cut
+
 1;
 
 =head1 AUTHOR
@@ -67,10 +67,26 @@ Enable CUDA code.
 
 Enable SSE code.
 
+=item C<--enable-avx> (default off)
+
+Enable SSE code, using 256-bit AVX2 instructions in place of 128-bit SSE
+instructions. Implies C<--enable-sse>.
+
+=item C<--enable-avx512> (default off)
+
+Enable SSE code, using 512-bit AVX-512 instructions in place of 128-bit SSE
+instructions. Implies C<--enable-sse>.
+
 =item C<--enable-mpi> (default off)
 
 Enable MPI code.
 
+=item C<--enable-philox> (default off)
+
+Use the counter-based Philox random number generator on host, in place of
+the Mersenne Twister. Random variates are then reproducible for a given
+C<--seed> regardless of the number of threads.
+
 =item C<--enable-vampir> (default off)
 
 Enable Vampir profiling.
@@ -128,7 +144,10 @@ sub new {
         _assert => 1,
         _cuda => 0,
         _sse => 0,
+        _avx => 0,
+        _avx512 => 0,
         _mpi => 0,
+        _philox => 0,
         _vampir => 0,
         _single => 0,
         _extra_debug => 0,
@@ -151,8 +170,14 @@ sub new {
         'disable-cuda' => sub { $self->{_cuda} = 0 },
         'enable-sse' => sub { $self->{_sse} = 1 },
         'disable-sse' => sub { $self->{_sse} = 0 },
+        'enable-avx' => sub { $self->{_avx} = 1 },
+        'disable-avx' => sub { $self->{_avx} = 0 },
+        'enable-avx512' => sub { $self->{_avx512} = 1 },
+        'disable-avx512' => sub { $self->{_avx512} = 0 },
         'enable-mpi' => sub { $self->{_mpi} = 1 },
         'disable-mpi' => sub { $self->{_mpi} = 0 },
+        'enable-philox' => sub { $self->{_philox} = 1 },
+        'disable-philox' => sub { $self->{_philox} = 0 },
         'enable-vampir' => sub { $self->{_vampir} = 1 },
         'disable-vampir' => sub { $self->{_vampir} = 0 },
         'enable-single' => sub { $self->{_single} = 1 },
@@ -168,10 +193,20 @@ sub new {
     );
     GetOptions(@args) || die("could not read command line arguments\n");
     
+    # AVX implies SSE, and AVX-512 supersedes AVX
+    if ($self->{_avx512}) {
+        $self->{_avx} = 0;
+    }
+    if ($self->{_avx} || $self->{_avx512}) {
+        $self->{_sse} = 1;
+    }
+
     # can't support SSE when CUDA enabled at this stage
     if ($self->{_cuda} && $self->{_sse}) {
     	warn("SSE has been disabled, unsupported when CUDA also enabled\n");
     	$self->{_sse} = 0;
+    	$self->{_avx} = 0;
+    	$self->{_avx512} = 0;
     }
     
     # enable mpirun automatically when --enable-mpi used
@@ -184,7 +219,10 @@ sub new {
     push(@builddir, 'assert') if $self->{_assert};
     push(@builddir, 'cuda') if $self->{_cuda};
     push(@builddir, 'sse') if $self->{_sse};
+    push(@builddir, 'avx') if $self->{_avx};
+    push(@builddir, 'avx512') if $self->{_avx512};
     push(@builddir, 'mpi') if $self->{_mpi};
+    push(@builddir, 'philox') if $self->{_philox};
     push(@builddir, 'vampir') if $self->{_vampir};
     push(@builddir, 'single') if $self->{_single};
     push(@builddir, 'extradebug') if $self->{_extra_debug};
@@ -303,7 +341,10 @@ sub _configure {
     $options .= $self->{_assert} ? ' --enable-assert' : ' --disable-assert';
     $options .= $self->{_cuda} ? ' --enable-cuda' : ' --disable-cuda';
     $options .= $self->{_sse} ? ' --enable-sse' : ' --disable-sse';
+    $options .= $self->{_avx} ? ' --enable-avx' : ' --disable-avx';
+    $options .= $self->{_avx512} ? ' --enable-avx512' : ' --disable-avx512';
     $options .= $self->{_mpi} ? ' --enable-mpi' : ' --disable-mpi';
+    $options .= $self->{_philox} ? ' --enable-philox' : ' --disable-philox';
     $options .= $self->{_vampir} ? ' --enable-vampir' : ' --disable-vampir';
     $options .= $self->{_single} ? ' --enable-single' : ' --disable-single';
     $options .= $self->{_extra_debug} ? ' --enable-extradebug' : ' --disable-extradebug';
@@ -170,6 +170,18 @@ Number of steps to take.
 
 =back
 
+=head2 Distributed resampler-specific options
+
+=over 4
+
+=item C<--with-async-redistribute> (default off)
+
+When distributed with C<--enable-mpi>, propagate the particles that remain
+in each process after resampling while those migrating between processes
+are still in transit, rather than waiting for all transfers to complete.
+
+=back
+
 =begin comment
 =head2 Adaptive particle filter-specific options
 
@@ -287,6 +299,11 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 0
     },
+    {
+      name => 'with-async-redistribute',
+      type => 'bool',
+      default => 0
+    },
     {
       name => 'stopper',
       type => 'string',
@@ -90,6 +90,44 @@ unless one of the adaptation strategies below is enabled.
 
 Number of samples to draw.
 
+=item C<--with-input-preload> (default off)
+
+Read all inputs and observations in one pass at startup, rather than each
+as it is first needed. This saves the first iteration from making many small
+reads as it goes.
+
+=item C<--with-input-store> (default off)
+
+Read inputs and observations from compact binary stores, rather than from
+the NetCDF files given by C<--input-file> and C<--obs-file>. Each store is
+kept alongside its NetCDF file, with the C<ns> and C<np> indices and the
+precision appended to its name (e.g. F<input.nc.ns0.npall.double.store>),
+and is derived from that file on first use, or whenever the file has
+changed. The stores are memory mapped, so that all runs on the one machine
+share a single copy of them. Where many runs start together, it is best to derive the
+stores with a single run first.
+
+=back
+
+=head2 PMMH-specific options
+
+=over 4
+
+=item C<--nchains> (default 1)
+
+Number of independent chains to run. Chains are distributed across threads,
+each drawing C<--nsamples> samples, and their samples interleaved in the
+output file, with the C<chain> variable giving the chain of each. Not
+supported with C<--filter adaptive>.
+
+=item C<--input-lookahead> (default 0)
+
+Read inputs and observations on a background thread, this many times ahead
+of their use, rather than each as it is first needed. This is an alternative
+to C<--with-input-preload> where reading all inputs at startup would itself
+take too long. Zero to disable. With C<--nchains> greater than one,
+C<--with-input-preload> is used instead.
+
 =back
 
 =head2 SMC2-specific options
@@ -107,6 +145,14 @@ particles will only be resampled if ESS is below this proportion of
 C<--nsamples>. To always resample, use C<--sample-ess-rel 1>. To never
 resample, use C<--sample-ess-rel 0>.
 
+=item C<--with-parallel-moves> (default off)
+
+Rejuvenate parameter particles concurrently, one per thread. Each parameter
+particle is moved single-threaded with its own random number stream, so
+that results remain reproducible for a given C<--seed> and C<--nthreads>,
+although they differ from those without this option. Not supported with
+C<--filter adaptive>.
+
 =item C<--adapter> (default none)
 
 Adaptation strategy for rejuvenation proposals:
@@ -151,6 +197,26 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 1
     },
+    {
+      name => 'nchains',
+      type => 'int',
+      default => 1
+    },
+    {
+      name => 'with-input-preload',
+      type => 'bool',
+      default => 0
+    },
+    {
+      name => 'with-input-store',
+      type => 'bool',
+      default => 0
+    },
+    {
+      name => 'input-lookahead',
+      type => 'int',
+      default => 0
+    },
     {
       name => 'conditional-pf',
       type => 'int',
@@ -171,6 +237,11 @@ our @CLIENT_OPTIONS = (
       type => 'float',
       default => 0.5
     },
+    {
+      name => 'with-parallel-moves',
+      type => 'bool',
+      default => 0
+    },
     {
       name => 'adapter',
       type => 'string',
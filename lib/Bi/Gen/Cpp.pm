@@ -98,9 +98,16 @@ sub gen {
             }
         }
 
-        # actions
+        # actions, with Jacobians for those of stiff ode blocks
+        my %jacobian;
+        foreach my $block (@{$model->get_all_blocks}) {
+            if ($block->isa('Bi::Block::ode') && $block->is_stiff) {
+                map { $jacobian{$_->get_id} = 1 } @{$block->get_actions};
+            }
+        }
         foreach my $action (@{$model->get_all_actions}) {
-            $self->process_action($model, $action);
+            $self->process_action($model, $action,
+                exists $jacobian{$action->get_id});
         }
     }
         
@@ -189,15 +196,16 @@ sub process_block {
     $self->process_templates($template, { 'block' => $block, 'model' => $model }, $out);
 }
 
-=item B<process_action>(I<action>)
+=item B<process_action>(I<action>, I<jacobian>)
 
-Generate code for action.
+Generate code for action, including its Jacobian if I<jacobian> is true.
 
 =cut
 sub process_action {
     my $self = shift;
     my $model = shift;
     my $action = shift;
+    my $jacobian = shift || 0;
 
     my $template;
     my $out;
@@ -212,7 +220,7 @@ sub process_action {
     }
 
     $out = File::Spec->catfile('src', 'model', 'action', 'Action' . $action->get_id);
-    $self->process_templates($template, { 'action' => $action, 'model' => $model }, $out);
+    $self->process_templates($template, { 'action' => $action, 'model' => $model, 'jacobian' => $jacobian }, $out);
 
     $template = 'action_coord';
     $out = File::Spec->catfile('src', 'model', 'action', 'ActionCoord' . $action->get_id);
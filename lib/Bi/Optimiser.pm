@@ -73,6 +73,13 @@ sub optimise {
     
     Bi::Visitor::Unroller->evaluate($model);
     Bi::Visitor::Wrapper->evaluate($model);
+
+    # hidden variables to carry integrator step sizes between calls
+    foreach my $block (@{$model->get_all_blocks}) {
+        if ($block->isa('Bi::Block::ode') && $block->carries_step) {
+            $block->add_step_vars($model);
+        }
+    }
 }
 
 1;
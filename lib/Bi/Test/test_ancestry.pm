@@ -0,0 +1,76 @@
+=head1 NAME
+
+test_ancestry - time ancestry cache writes.
+
+=head1 SYNOPSIS
+
+    libbi test_ancestry ...
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=cut
+
+package Bi::Test::test_ancestry;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--Ps> (default 5)
+
+Number of numbers of particles to use. These are successive powers of ten,
+starting at 100, so that the default goes up to 10^6.
+
+=item C<--generations> (default 100)
+
+Number of generations to write for each number of particles.
+
+=item C<--with-prune> (default on)
+
+Prune the ancestry tree on each write.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'Ps',
+      type => 'int',
+      default => 5
+    },
+    {
+      name => 'generations',
+      type => 'int',
+      default => 100
+    },
+    {
+      name => 'with-prune',
+      type => 'bool',
+      default => 1
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_ancestry';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+1;
+
+=back
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
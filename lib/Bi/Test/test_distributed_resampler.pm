@@ -0,0 +1,85 @@
+=head1 NAME
+
+test_distributed_resampler - test distributed resampler.
+
+=head1 SYNOPSIS
+
+    libbi test_distributed_resampler --with-mpi --mpi-np 4 ...
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=head1 DESCRIPTION
+
+Resamples particles across processes with the distributed resampler, and
+checks that particles arrive intact, that the number of particles is
+preserved, and that particles with zero weight are never chosen. Each
+particle is labelled with its global index in all of its state variables,
+so the model must have at least one state variable. Must be run with
+C<--with-mpi>, typically with several processes.
+
+=cut
+
+package Bi::Test::test_distributed_resampler;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--nparticles> (default 1024)
+
+Number of particles in each process.
+
+=item C<--reps> (default 10)
+
+Number of trials of each test.
+
+=item C<--with-async-redistribute> (default off)
+
+Leave receipt of particles outstanding on return from resampling, then
+complete it, as the particle filter does with this option.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'nparticles',
+      type => 'int',
+      default => 1024
+    },
+    {
+      name => 'reps',
+      type => 'int',
+      default => 10
+    },
+    {
+      name => 'with-async-redistribute',
+      type => 'bool',
+      default => 0
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_distributed_resampler';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+1;
+
+=back
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
@@ -0,0 +1,137 @@
+=head1 NAME
+
+test_ode - test and time integration of ode blocks.
+
+=head1 SYNOPSIS
+
+    libbi test_ode --model-file Model.bi ...
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=head1 DESCRIPTION
+
+Integrates the model forward from C<0.0> to C<--end-time>, without noise,
+for numbers of trajectories from 10 up, and times this with each trajectory
+taking its own step size and with all trajectories integrated together with
+SSE instructions taking a common step size. The parameters and initial
+conditions are sampled once, or read from C<--init-file>, and shared by all
+runs. The final state of each run is checked against that of a single run
+over all trajectories. The two should agree, to within the error
+tolerances of the model's ode blocks, whatever the number of trajectories
+and whichever trajectory comes first. A model whose transition has only ode
+blocks times just the integrator.
+
+Each C<RK5(4)> ode block of the transition is then also integrated alone,
+over the largest number of trajectories, with the host integrator that
+integrates trajectories in tiles and with the one that integrates them one
+at a time. These are timed against each other, and should agree to within
+C<--tolerance>. This is done on host only, and whether or not SSE
+instructions are enabled.
+
+To compare the two by state dimension, use ode blocks of different sizes,
+for example:
+
+    model TestODE {
+      dim n1(10)
+      dim n2(100)
+      dim n3(1000)
+
+      state x1[n1]
+      state x2[n2]
+      state x3[n3]
+
+      sub initial {
+        x1 ~ uniform(-1.0, 1.0)
+        x2 ~ uniform(-1.0, 1.0)
+        x3 ~ uniform(-1.0, 1.0)
+      }
+
+      sub transition {
+        ode(alg = 'RK5(4)', h = 1.0e-2, atoler = 1.0e-6, rtoler = 1.0e-6) {
+          dx1[i]/dt = -x1[i] + sin(4.0*x1[i])
+        }
+        ode(alg = 'RK5(4)', h = 1.0e-2, atoler = 1.0e-6, rtoler = 1.0e-6) {
+          dx2[i]/dt = -x2[i] + sin(4.0*x2[i])
+        }
+        ode(alg = 'RK5(4)', h = 1.0e-2, atoler = 1.0e-6, rtoler = 1.0e-6) {
+          dx3[i]/dt = -x3[i] + sin(4.0*x3[i])
+        }
+      }
+    }
+
+=cut
+
+package Bi::Test::test_ode;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--end-time> (default 1.0)
+
+End time.
+
+=item C<--Ns> (default 3)
+
+Number of numbers of trajectories to use. These are successive powers of
+ten, starting at 10, so that the default goes up to 1000.
+
+=item C<--reps> (default 10)
+
+Number of trials for each number of trajectories.
+
+=item C<--tolerance> (default 1.0e-2)
+
+Largest error allowed in the final state, relative to one plus its
+magnitude in the single run over all trajectories.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'end-time',
+      type => 'float',
+      default => 1.0
+    },
+    {
+      name => 'Ns',
+      type => 'int',
+      default => 3
+    },
+    {
+      name => 'reps',
+      type => 'int',
+      default => 10
+    },
+    {
+      name => 'tolerance',
+      type => 'float',
+      default => 1.0e-2
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_ode';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+1;
+
+=back
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
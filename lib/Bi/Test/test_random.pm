@@ -0,0 +1,71 @@
+=head1 NAME
+
+test_random - test and time random number generation.
+
+=head1 SYNOPSIS
+
+    libbi test_random ...
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=cut
+
+package Bi::Test::test_random;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--Ns> (default 4)
+
+Number of numbers of variates to use. These are successive powers of ten,
+starting at 1000, so that the default goes up to 10^6.
+
+=item C<--reps> (default 10)
+
+Number of trials for each distribution and number of variates.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'Ns',
+      type => 'int',
+      default => 4
+    },
+    {
+      name => 'reps',
+      type => 'int',
+      default => 10
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_random';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+sub needs_model {
+    return 0;
+}
+
+1;
+
+=back
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
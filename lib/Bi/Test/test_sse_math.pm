@@ -0,0 +1,77 @@
+=head1 NAME
+
+test_sse_math - test and time vectorised math functions.
+
+=head1 SYNOPSIS
+
+    libbi test_sse_math --enable-sse ...
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=head1 DESCRIPTION
+
+Times exp(), log() and pow() on sse_real against the scalar functions, and
+measures their error in ulp against a long double reference. Also checks
+special values against the scalar functions. Must be built with
+C<--enable-sse>, C<--enable-avx> or C<--enable-avx512>.
+
+=cut
+
+package Bi::Test::test_sse_math;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--nvalues> (default 1048576)
+
+Number of arguments to evaluate each function on.
+
+=item C<--reps> (default 10)
+
+Number of trials for each function.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'nvalues',
+      type => 'int',
+      default => 1048576
+    },
+    {
+      name => 'reps',
+      type => 'int',
+      default => 10
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_sse_math';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+sub needs_model {
+    return 0;
+}
+
+1;
+
+=back
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
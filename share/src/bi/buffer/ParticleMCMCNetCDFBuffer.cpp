@@ -9,22 +9,28 @@
 
 bi::ParticleMCMCNetCDFBuffer::ParticleMCMCNetCDFBuffer(const Model& m,
     const std::string& file, const FileMode mode) :
-    NetCDFBuffer(file, mode), m(m), vars(NUM_VAR_TYPES) {
+    NetCDFBuffer(file, mode), m(m), ncDim(NULL), vars(NUM_VAR_TYPES),
+    cVar(NULL) {
   BI_ASSERT(mode == READ_ONLY || mode == WRITE);
   map();
 }
 
 bi::ParticleMCMCNetCDFBuffer::ParticleMCMCNetCDFBuffer(const Model& m,
     const int P, const int T, const std::string& file,
-    const FileMode mode) : NetCDFBuffer(file, mode), m(m), vars(NUM_VAR_TYPES) {
+    const FileMode mode, const int C) : NetCDFBuffer(file, mode), m(m),
+    ncDim(NULL), vars(NUM_VAR_TYPES), cVar(NULL) {
+  /* pre-condition */
+  BI_ASSERT(C >= 1);
+
   if (mode == NEW || mode == REPLACE) {
-    create(P, T);
+    create(P, T, C);
   } else {
     map(P, T);
   }
 }
 
-void bi::ParticleMCMCNetCDFBuffer::create(const long P, const long T) {
+void bi::ParticleMCMCNetCDFBuffer::create(const long P, const long T,
+    const long C) {
   int id, i;
   VarType type;
   Var* var;
@@ -73,6 +79,19 @@ void bi::ParticleMCMCNetCDFBuffer::create(const long P, const long T) {
   BI_ERROR_MSG(lpVar != NULL && lpVar->is_valid(),
       "Could not create logprior variable");
 
+  if (C > 1) {
+    ncDim = createDim("nc", C);
+    cVar = ncFile->add_var("chain", ncInt, npDim);
+    BI_ERROR_MSG(cVar != NULL && cVar->is_valid(),
+        "Could not create chain variable");
+
+    /* samples are interleaved across chains, so chain is known up front */
+    host_vector<int> cs(P);
+    for (int p = 0; p < P; ++p) {
+      cs(p) = p % C;
+    }
+    write1d(cVar, 0, cs);
+  }
 }
 
 void bi::ParticleMCMCNetCDFBuffer::map(const long P, const long T) {
@@ -132,4 +151,15 @@ void bi::ParticleMCMCNetCDFBuffer::map(const long P, const long T) {
   BI_ERROR_MSG(lpVar->get_dim(0) == npDim,
       "Dimension 0 of variable logprior should be np");
 
+  /* chain variable is optional, present only for multiple chains */
+  if (hasDim("nc")) {
+    ncDim = mapDim("nc");
+    cVar = ncFile->get_var("chain");
+    BI_ERROR_MSG(cVar != NULL && cVar->is_valid(),
+        "File does not contain variable chain");
+    BI_ERROR_MSG(cVar->num_dims() == 1, "Variable chain has " <<
+        cVar->num_dims() << " dimensions, should have 1");
+    BI_ERROR_MSG(cVar->get_dim(0) == npDim,
+        "Dimension 0 of variable chain should be np");
+  }
 }
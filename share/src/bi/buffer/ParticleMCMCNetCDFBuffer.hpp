@@ -41,9 +41,13 @@ public:
    * @param T Number of time points in file.
    * @param file NetCDF file name.
    * @param mode File open mode.
+   * @param C Number of chains. When greater than one, samples are assumed
+   * interleaved across chains, and a @c chain variable is created to record
+   * the chain of each sample.
    */
   ParticleMCMCNetCDFBuffer(const Model& m, const int P, const int T,
-      const std::string& file, const FileMode mode = READ_ONLY);
+      const std::string& file, const FileMode mode = READ_ONLY,
+      const int C = 1);
 
   /**
    * Read times.
@@ -185,8 +189,9 @@ protected:
    *
    * @param P Number of particles.
    * @param T Number of time points.
+   * @param C Number of chains.
    */
-  void create(const long P, const long T);
+  void create(const long P, const long T, const long C = 1);
 
   /**
    * Map structure of existing NetCDF file.
@@ -213,6 +218,11 @@ protected:
    */
   NcDim* npDim;
 
+  /**
+   * C-dimension (chains).
+   */
+  NcDim* ncDim;
+
   /**
    * Time variable.
    */
@@ -232,6 +242,11 @@ protected:
    * Log-prior densities variable.
    */
   NcVar* lpVar;
+
+  /**
+   * Chain index variable.
+   */
+  NcVar* cVar;
 };
 
 }
@@ -0,0 +1,322 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#include "SparseInputStore.hpp"
+
+#include "../misc/assert.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+ * Layout of a store. All offsets are in bytes from the start of the file,
+ * and aligned to eight bytes. The header is followed by the values of static
+ * inputs, then, for each of F_VAR and O_VAR, a table of one record per time,
+ * then the blocks of those records. Each block holds the information of the
+ * mask (three ints per variable, as in Mask), the sparse indices of the mask
+ * (ints), then the values under the mask (reals). For F_VAR, every
+ * STORE_INTERVAL-th block, starting with the first, is followed by the
+ * values of all inputs after the updates up to and including that time.
+ */
+namespace {
+const char STORE_MAGIC[8] = { 'L', 'I', 'B', 'B', 'I', 'S', 'T', 'O' };
+const int STORE_VERSION = 3;
+const int STORE_ORDER = 0x01020304;
+const int STORE_SLOTS = 2;
+const int STORE_INTERVAL = 16;
+
+struct StoreHeader {
+  char magic[8];
+  int version, order, realSize, ns, np, K, interval;
+  int numVars[STORE_SLOTS];
+  int netSize[STORE_SLOTS];
+  long long sourceSize, sourceTime;
+  long long offset0;
+  long long offsets[STORE_SLOTS];
+};
+
+struct StoreRecord {
+  long long offset, full;
+  int nixs, nvals;
+};
+
+inline long long align(const long long offset) {
+  return (offset + 7) & ~7LL;
+}
+}
+
+bi::SparseInputStore::SparseInputStore(const Model& m,
+    SparseInputNetCDFBuffer& in, const std::string& file, const int ns,
+    const int np) : m(m), base(NULL), length(0), masks(STORE_SLOTS),
+    values(STORE_SLOTS), values0(NULL), interval(STORE_INTERVAL) {
+  std::string store = name(file, ns, np);
+  if (!isCurrent(store, file, ns, np)) {
+    create(in, store, file, ns, np);
+  }
+  map(store);
+}
+
+bi::SparseInputStore::~SparseInputStore() {
+  if (base != NULL) {
+    munmap(base, length);
+  }
+}
+
+bool bi::SparseInputStore::isCurrent(const std::string& file,
+    const std::string& source, const int ns, const int np) const {
+  struct stat st;
+  StoreHeader header;
+  int i;
+
+  if (stat(source.c_str(), &st) != 0) {
+    return false;
+  }
+  std::ifstream is(file.c_str(), std::ios::in | std::ios::binary);
+  if (!is.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+
+  bool current = std::memcmp(header.magic, STORE_MAGIC, 8) == 0 &&
+      header.version == STORE_VERSION && header.order == STORE_ORDER &&
+      header.realSize == (int)sizeof(real) && header.ns == ns &&
+      header.np == np && header.sourceSize == (long long)st.st_size &&
+      header.sourceTime == (long long)st.st_mtime;
+  for (i = 0; current && i < STORE_SLOTS; ++i) {
+    const VarType type = (i == 0) ? F_VAR : O_VAR;
+    current = header.numVars[i] == m.getNumVars(type) &&
+        header.netSize[i] == m.getNetSize(type);
+  }
+  return current;
+}
+
+void bi::SparseInputStore::create(SparseInputNetCDFBuffer& in,
+    const std::string& file, const std::string& source, const int ns,
+    const int np) {
+  typedef host_matrix<real> matrix_type;
+  typedef host_vector<real> vector_type;
+  typedef host_vector<int> int_vector_type;
+
+  struct stat st;
+  StoreHeader header;
+  std::vector<StoreRecord> records;
+  Mask<ON_HOST> mask;
+  Var* var;
+  long long offset;
+  int i, k, id, j, n, start, size;
+
+  BI_ERROR_MSG(stat(source.c_str(), &st) == 0, "Could not stat " << source);
+
+  /* unique temporary file alongside the store, renamed once complete */
+  std::vector<char> tmp(file.begin(), file.end());
+  const char suffix[] = ".XXXXXX";
+  tmp.insert(tmp.end(), suffix, suffix + sizeof(suffix));
+  int fd = mkstemp(&tmp[0]);
+  BI_ERROR_MSG(fd >= 0, "Could not create " << &tmp[0]);
+  fchmod(fd, 0644);  // mkstemp() gives 0600, store is shared
+  close(fd);
+  std::ofstream os(&tmp[0], std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  BI_ERROR_MSG(os.good(), "Could not open " << &tmp[0]);
+
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, STORE_MAGIC, 8);
+  header.version = STORE_VERSION;
+  header.order = STORE_ORDER;
+  header.realSize = sizeof(real);
+  header.ns = ns;
+  header.np = np;
+  header.K = in.getTimes().size();
+  header.interval = STORE_INTERVAL;
+  header.sourceSize = st.st_size;
+  header.sourceTime = st.st_mtime;
+  for (i = 0; i < STORE_SLOTS; ++i) {
+    const VarType type = (i == 0) ? F_VAR : O_VAR;
+    header.numVars[i] = m.getNumVars(type);
+    header.netSize[i] = m.getNetSize(type);
+  }
+
+  /* static inputs */
+  offset = align(sizeof(header));
+  header.offset0 = offset;
+  matrix_type X0(1, header.netSize[0]);
+  X0.clear();
+  in.read0(F_VAR, X0);
+  os.seekp(offset);
+  os.write(reinterpret_cast<const char*>(X0.buf()),
+      header.netSize[0]*sizeof(real));
+  offset = align(offset + header.netSize[0]*sizeof(real));
+
+  /* dynamic inputs and observations; inputs accumulate over time, from the
+   * static inputs, so that each full vector of inputs is as Forcer would
+   * have after reading all times up to it in order */
+  for (i = 0; i < STORE_SLOTS; ++i) {
+    const VarType type = (i == 0) ? F_VAR : O_VAR;
+    const int N = header.netSize[i];
+    matrix_type X(1, N);
+    int_vector_type info(3*header.numVars[i]);
+
+    if (type == F_VAR) {
+      X = X0;
+    }
+
+    header.offsets[i] = offset;
+    records.resize(header.K);
+    offset = align(offset + header.K*sizeof(StoreRecord));
+
+    for (k = 0; k < header.K; ++k) {
+      in.readMask(k, type, mask);
+      if (type == O_VAR) {
+        X.clear();
+      }
+      in.readState(k, type, mask, X);
+
+      /* mask in the layout of Mask, indices in order of variables */
+      int_vector_type ixs(mask.size());
+      vector_type x(mask.size());
+      n = 0;
+      start = 0;
+      for (id = 0; id < header.numVars[i]; ++id) {
+        size = mask.getSize(id);
+        info(3*id) = mask.isDense(id) ? size : 0;
+        info(3*id + 1) = mask.isSparse(id) ? size : 0;
+        info(3*id + 2) = start;
+        if (size > 0) {
+          var = m.getVar(type, id);
+          for (j = 0; j < size; ++j) {
+            if (mask.isSparse(id)) {
+              ixs(start + j) = mask.getIndex(id, j);
+            }
+            x(n + j) = X(0, var->getStart() + mask.getIndex(id, j));
+          }
+          if (mask.isSparse(id)) {
+            start += size;
+          }
+          n += size;
+        }
+      }
+
+      records[k].offset = offset;
+      records[k].full = 0;
+      records[k].nixs = start;
+      records[k].nvals = n;
+
+      os.seekp(offset);
+      os.write(reinterpret_cast<const char*>(info.buf()),
+          info.size()*sizeof(int));
+      offset += info.size()*sizeof(int);
+      os.write(reinterpret_cast<const char*>(ixs.buf()), start*sizeof(int));
+      offset = align(offset + start*sizeof(int));
+      os.seekp(offset);
+      os.write(reinterpret_cast<const char*>(x.buf()), n*sizeof(real));
+      offset = align(offset + n*sizeof(real));
+
+      if (type == F_VAR && k % header.interval == 0) {
+        records[k].full = offset;
+        os.seekp(offset);
+        os.write(reinterpret_cast<const char*>(X.buf()), N*sizeof(real));
+        offset = align(offset + N*sizeof(real));
+      }
+    }
+
+    if (header.K > 0) {
+      os.seekp(header.offsets[i]);
+      os.write(reinterpret_cast<const char*>(&records[0]),
+          header.K*sizeof(StoreRecord));
+    }
+  }
+
+  /* header, now that offsets are known */
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.close();
+  BI_ERROR_MSG(!os.fail(), "Could not write " << &tmp[0]);
+
+  BI_ERROR_MSG(std::rename(&tmp[0], file.c_str()) == 0, "Could not rename " <<
+      &tmp[0] << " to " << file);
+}
+
+void bi::SparseInputStore::map(const std::string& file) {
+  struct stat st;
+  int i, k;
+
+  int fd = open(file.c_str(), O_RDONLY);
+  BI_ERROR_MSG(fd >= 0, "Could not open " << file);
+  BI_ERROR_MSG(fstat(fd, &st) == 0, "Could not stat " << file);
+  length = st.st_size;
+  void* ptr = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  BI_ERROR_MSG(ptr != MAP_FAILED, "Could not map " << file);
+  base = static_cast<char*>(ptr);
+
+  const StoreHeader* header = reinterpret_cast<const StoreHeader*>(base);
+  BI_ERROR_MSG(length >= sizeof(StoreHeader) &&
+      std::memcmp(header->magic, STORE_MAGIC, 8) == 0, "Invalid store " <<
+      file);
+
+  values0 = reinterpret_cast<real*>(base + header->offset0);
+  interval = header->interval;
+  fulls.clear();
+
+  for (i = 0; i < STORE_SLOTS; ++i) {
+    const StoreRecord* records = reinterpret_cast<const StoreRecord*>(base +
+        header->offsets[i]);
+    const int numVars = header->numVars[i];
+
+    masks[i].clear();
+    values[i].clear();
+    masks[i].reserve(header->K);
+    values[i].reserve(header->K);
+    for (k = 0; k < header->K; ++k) {
+      int* info = reinterpret_cast<int*>(base + records[k].offset);
+      int* ixs = info + 3*numVars;
+      real* x = reinterpret_cast<real*>(base + align(records[k].offset +
+          (3*numVars + records[k].nixs)*sizeof(int)));
+
+      masks[i].push_back(Mask<ON_HOST>(
+          host_matrix_reference<int>(info, 3, numVars, 3),
+          host_vector_reference<int>(ixs, records[k].nixs)));
+      values[i].push_back(x);
+      if (records[k].full > 0) {
+        fulls.push_back(reinterpret_cast<real*>(base + records[k].full));
+      }
+
+      BI_ASSERT(masks[i].back().size() == records[k].nvals);
+    }
+  }
+}
+
+std::string bi::SparseInputStore::name(const std::string& file,
+    const int ns, const int np) {
+  std::stringstream buf;
+
+  buf << file << ".ns" << ns << ".np";
+  if (np >= 0) {
+    buf << np;
+  } else {
+    buf << "all";
+  }
+  buf << ((sizeof(real) == sizeof(float)) ? ".single" : ".double");
+  buf << ".store";
+
+  return buf.str();
+}
+
+int bi::SparseInputStore::slot(const VarType type) {
+  /* pre-condition */
+  BI_ASSERT(type == F_VAR || type == O_VAR);
+
+  return (type == F_VAR) ? 0 : 1;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_BUFFER_SPARSEINPUTSTORE_HPP
+#define BI_BUFFER_SPARSEINPUTSTORE_HPP
+
+#include "SparseInputNetCDFBuffer.hpp"
+#include "../state/Mask.hpp"
+#include "../model/Model.hpp"
+#include "../math/vector.hpp"
+
+#include <vector>
+#include <string>
+
+namespace bi {
+/**
+ * Read-only, memory-mapped store of inputs and observations in sparse
+ * format.
+ *
+ * @ingroup io_buffer
+ *
+ * The store is a compact binary file derived from a NetCDF file, holding
+ * static inputs, and, for each time, the masks of dynamic inputs and
+ * observations, along with the values under them. Every sixteenth time
+ * also holds the full vector of inputs at that time, from which read()
+ * rebuilds the inputs at any later time by applying the updates of at most
+ * fifteen times. Times may so be read in any order, as when a filter
+ * restarts from an earlier time, while the store grows with the updates
+ * rather than with the number of times multiplied by the number of inputs.
+ * The store is mapped read-only, so that all processes on a node that open
+ * the same store share the one copy in the page cache, and masks and values
+ * are read from the mapping without copying.
+ *
+ * The store is kept next to the NetCDF file, with the @c ns and @c np
+ * indices and the precision appended to its name, see name(). It is derived
+ * on construction if it does not exist, or if it was derived from a
+ * different version of the NetCDF file. Derivation writes to a temporary
+ * file that is then renamed, so that processes starting together may each
+ * derive the store without harm, although the first run should preferably
+ * do so alone. The store is in native byte order, and so is not portable
+ * between platforms; it is derived anew if the byte order differs.
+ *
+ * Only dynamic and static inputs (F_VAR), and observations (O_VAR), are
+ * stored.
+ */
+class SparseInputStore {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param in NetCDF buffer from which to derive the store, if necessary.
+   * @param file NetCDF file name of @p in.
+   * @param ns Index along @c ns dimension used by @p in.
+   * @param np Index along @c np dimension used by @p in.
+   */
+  SparseInputStore(const Model& m, SparseInputNetCDFBuffer& in,
+      const std::string& file, const int ns = 0, const int np = -1);
+
+  /**
+   * Destructor.
+   */
+  ~SparseInputStore();
+
+  /**
+   * Name of store.
+   *
+   * @param file NetCDF file name.
+   * @param ns Index along @c ns dimension.
+   * @param np Index along @c np dimension.
+   *
+   * @return Name of the store derived from @p file with these indices, in
+   * the precision of this build, e.g. @c input.nc.ns0.npall.double.store.
+   */
+  static std::string name(const std::string& file, const int ns = 0,
+      const int np = -1);
+
+  /**
+   * Number of times.
+   */
+  int size() const;
+
+  /**
+   * Get mask of dynamic variables.
+   *
+   * @param k Time index.
+   * @param type Variable type, F_VAR or O_VAR.
+   *
+   * @return Mask, a view of the store.
+   */
+  const Mask<ON_HOST>& getMask(const int k, const VarType type) const;
+
+  /**
+   * Get values of dynamic variables.
+   *
+   * @param k Time index.
+   * @param type Variable type, F_VAR or O_VAR.
+   *
+   * @return Values under the mask given by getMask(), for each variable in
+   * turn; a view of the store.
+   */
+  const host_vector_reference<real> getValues(const int k,
+      const VarType type) const;
+
+  /**
+   * Get values of static variables.
+   *
+   * @param type Variable type, F_VAR.
+   *
+   * @return Values of all variables of the type, a view of the store.
+   */
+  const host_vector_reference<real> getValues0(const VarType type) const;
+
+  /**
+   * Read dynamic variables.
+   *
+   * @tparam M1 Matrix type.
+   *
+   * @param k Time index.
+   * @param type Variable type, F_VAR or O_VAR.
+   * @param[in,out] X State. For F_VAR, all values are written, as after
+   * reading all times up to @p k in order. For O_VAR, only values under the
+   * mask are written, those of other variables are left unchanged, as for
+   * SparseInputNetCDFBuffer::read().
+   */
+  template<class M1>
+  void read(const int k, const VarType type, M1 X) const;
+
+  /**
+   * Read static variables.
+   *
+   * @tparam M1 Matrix type.
+   *
+   * @param type Variable type, F_VAR.
+   * @param[out] X State.
+   */
+  template<class M1>
+  void read0(const VarType type, M1 X) const;
+
+private:
+  /**
+   * Copy constructor, not implemented.
+   */
+  SparseInputStore(const SparseInputStore& o);
+
+  /**
+   * Assignment operator, not implemented.
+   */
+  SparseInputStore& operator=(const SparseInputStore& o);
+
+  /**
+   * Is the store current?
+   *
+   * @param file Store file name.
+   * @param source NetCDF file name.
+   * @param ns Index along @c ns dimension.
+   * @param np Index along @c np dimension.
+   */
+  bool isCurrent(const std::string& file, const std::string& source,
+      const int ns, const int np) const;
+
+  /**
+   * Derive the store from NetCDF.
+   *
+   * @param in NetCDF buffer.
+   * @param file Store file name.
+   * @param source NetCDF file name.
+   * @param ns Index along @c ns dimension.
+   * @param np Index along @c np dimension.
+   */
+  void create(SparseInputNetCDFBuffer& in, const std::string& file,
+      const std::string& source, const int ns, const int np);
+
+  /**
+   * Map the store and construct views of its masks.
+   *
+   * @param file Store file name.
+   */
+  void map(const std::string& file);
+
+  /**
+   * Write values under mask into state.
+   *
+   * @tparam M1 Matrix type.
+   *
+   * @param k Time index.
+   * @param type Variable type, F_VAR or O_VAR.
+   * @param[in,out] X State, on host.
+   */
+  template<class M1>
+  void scatter(const int k, const VarType type, M1 X) const;
+
+  /**
+   * Index of variable type in the store.
+   */
+  static int slot(const VarType type);
+
+  /**
+   * Model.
+   */
+  const Model& m;
+
+  /**
+   * Start of mapping.
+   */
+  char* base;
+
+  /**
+   * Length of mapping.
+   */
+  size_t length;
+
+  /**
+   * Masks, indexed by slot then time.
+   */
+  std::vector<std::vector<Mask<ON_HOST> > > masks;
+
+  /**
+   * Values, indexed by slot then time. The number of values is the size of
+   * the corresponding mask.
+   */
+  std::vector<std::vector<real*> > values;
+
+  /**
+   * Values of static variables.
+   */
+  real* values0;
+
+  /**
+   * Values of all inputs, every #interval times, starting with the first.
+   */
+  std::vector<real*> fulls;
+
+  /**
+   * Number of times between full vectors of inputs.
+   */
+  int interval;
+};
+}
+
+#include "../math/temp_matrix.hpp"
+#include "../primitive/vector_primitive.hpp"
+#include "../primitive/matrix_primitive.hpp"
+
+inline int bi::SparseInputStore::size() const {
+  return masks[0].size();
+}
+
+inline const bi::Mask<bi::ON_HOST>& bi::SparseInputStore::getMask(
+    const int k, const VarType type) const {
+  /* pre-condition */
+  BI_ASSERT(k >= 0 && k < size());
+
+  return masks[slot(type)][k];
+}
+
+inline const bi::host_vector_reference<real> bi::SparseInputStore::getValues(
+    const int k, const VarType type) const {
+  /* pre-condition */
+  BI_ASSERT(k >= 0 && k < size());
+
+  return host_vector_reference<real>(values[slot(type)][k],
+      getMask(k, type).size());
+}
+
+inline const bi::host_vector_reference<real> bi::SparseInputStore::getValues0(
+    const VarType type) const {
+  /* pre-condition */
+  BI_ASSERT(type == F_VAR);
+
+  return host_vector_reference<real>(values0, m.getNetSize(type));
+}
+
+template<class M1>
+void bi::SparseInputStore::read(const int k, const VarType type, M1 X) const {
+  /* pre-condition */
+  BI_ASSERT(k >= 0 && k < size());
+
+  if (type == F_VAR) {
+    /* rebuild from the last full vector at or before k */
+    const int N = m.getNetSize(type);
+    typename temp_host_matrix<real>::type X1(1, N);
+    int j;
+
+    row(X1, 0) = host_vector_reference<real>(fulls[k/interval], N);
+    for (j = k - k % interval + 1; j <= k; ++j) {
+      scatter(j, type, X1);
+    }
+    set_rows(X, row(X1, 0));
+  } else if (M1::on_device) {
+    typename temp_host_matrix<real>::type X1(X.size1(), X.size2());
+    X1 = X;
+    scatter(k, type, X1);
+    X = X1;
+  } else {
+    scatter(k, type, X);
+  }
+}
+
+template<class M1>
+void bi::SparseInputStore::read0(const VarType type, M1 X) const {
+  set_rows(X, getValues0(type));
+}
+
+template<class M1>
+void bi::SparseInputStore::scatter(const int k, const VarType type, M1 X)
+    const {
+  const Mask<ON_HOST>& mask = getMask(k, type);
+  const host_vector_reference<real> x = getValues(k, type);
+  Var* var;
+  int id, j, size, i = 0;
+
+  for (id = 0; id < mask.getNumVars(); ++id) {
+    size = mask.getSize(id);
+    if (size > 0) {
+      var = m.getVar(type, id);
+      for (j = 0; j < size; ++j) {
+        set_elements(column(X, var->getStart() + mask.getIndex(id, j)),
+            x(i + j));
+      }
+      i += size;
+    }
+  }
+}
+
+#endif
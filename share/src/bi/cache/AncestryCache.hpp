@@ -39,6 +39,11 @@ public:
    */
   typedef typename loc_temp_vector<CL,int>::type int_vector_type;
 
+  /**
+   * Host integer vector type.
+   */
+  typedef typename temp_host_vector<int>::type host_int_vector_type;
+
   /**
    * Constructor.
    */
@@ -80,6 +85,23 @@ public:
   template<class M1>
   void readTrajectory(const int p, M1 X) const;
 
+  /**
+   * Read multiple trajectories from the cache.
+   *
+   * @tparam V1 Integer vector type.
+   * @tparam M1 Matrix type.
+   *
+   * @param ps Indices of particles at current time.
+   * @param[out] X Trajectories. Rows index variables, columns index times,
+   * with the trajectory of particle <tt>ps(k)</tt> in columns
+   * <tt>k*T</tt> to <tt>(k + 1)*T - 1</tt>, where <tt>T = X.size2()/ps.size()</tt>.
+   *
+   * All trajectories are traced back together, gathering the particles of
+   * one generation at a time.
+   */
+  template<class V1, class M1>
+  void readTrajectories(const V1 ps, M1 X) const;
+
   /**
    * Add particles at a new time to the cache.
    *
@@ -156,6 +178,12 @@ private:
   template<class M1, class V1>
   void writeState(const M1 X, const V1 as, const bool r);
 
+  /**
+   * Get ancestors on host. On host this is @p as itself, on device a copy,
+   * kept until the ancestry next changes.
+   */
+  const host_int_vector_type& getHostAncestors() const;
+
   /**
    * Particles. Rows index particles, columns index variables.
    */
@@ -169,6 +197,16 @@ private:
    */
   int_vector_type as;
 
+  /**
+   * Host mirror of @p as, for device caches.
+   */
+  mutable host_int_vector_type asHost;
+
+  /**
+   * Is @p asHost up to date?
+   */
+  mutable bool asHostValid;
+
   /**
    * Offspring. Each entry, corresponding to a row in @p Xs, gives the
    * number of surviving children of that particle.
@@ -224,6 +262,8 @@ private:
 #include "../resampler/Resampler.hpp"
 #include "../math/temp_vector.hpp"
 #include "../math/temp_matrix.hpp"
+#include "../math/loc_temp_vector.hpp"
+#include "../math/loc_temp_matrix.hpp"
 #include "../math/view.hpp"
 #include "../math/serialization.hpp"
 #include "../primitive/vector_primitive.hpp"
@@ -233,13 +273,14 @@ private:
 
 template<bi::Location CL>
 bi::AncestryCache<CL>::AncestryCache() :
-    m(0), q(0), usecs(0) {
+    asHostValid(false), m(0), q(0), usecs(0) {
   //
 }
 
 template<bi::Location CL>
 bi::AncestryCache<CL>::AncestryCache(const AncestryCache<CL>& o) :
-    Xs(o.Xs), as(o.as), os(o.os), ls(o.ls), m(o.m), q(o.q), usecs(o.usecs) {
+    Xs(o.Xs), as(o.as), asHostValid(false), os(o.os), ls(o.ls), m(o.m),
+    q(o.q), usecs(o.usecs) {
   //
 }
 
@@ -258,6 +299,7 @@ bi::AncestryCache<CL>& bi::AncestryCache<CL>::operator=(
   m = o.m;
   q = o.q;
   usecs = o.usecs;
+  asHostValid = false;
 
   return *this;
 }
@@ -266,6 +308,8 @@ template<bi::Location CL>
 void bi::AncestryCache<CL>::swap(AncestryCache<CL>& o) {
   Xs.swap(o.Xs);
   as.swap(o.as);
+  asHost.swap(o.asHost);
+  std::swap(asHostValid, o.asHostValid);
   os.swap(o.os);
   ls.swap(o.ls);
   std::swap(m, o.m);
@@ -277,6 +321,7 @@ template<bi::Location CL>
 void bi::AncestryCache<CL>::clear() {
   os.clear();
   ls.resize(0, false);
+  asHostValid = false;
   m = 0;
   q = 0;
   usecs = 0;
@@ -288,6 +333,8 @@ void bi::AncestryCache<CL>::empty() {
   as.resize(0, false);
   os.resize(0, false);
   ls.resize(0, false);
+  asHost.resize(0, false);
+  asHostValid = false;
   m = 0;
   q = 0;
   usecs = 0;
@@ -300,11 +347,7 @@ void bi::AncestryCache<CL>::readTrajectory(const int p, M1 X) const {
   BI_ASSERT(X.size1() == Xs.size2());
   BI_ASSERT(p >= 0 && p < ls.size());
 
-  ///@todo Implement this with scatter, so that one kernel call on device
-
-  typename temp_host_vector<int>::type as1(as);
-  synchronize(as.on_device);
-
+  const host_int_vector_type& as1 = getHostAncestors();
   int a = *(ls.begin() + p);
   int t = X.size2() - 1;
   do {
@@ -314,6 +357,46 @@ void bi::AncestryCache<CL>::readTrajectory(const int p, M1 X) const {
   } while (a != -1);
 }
 
+template<bi::Location CL>
+template<class V1, class M1>
+void bi::AncestryCache<CL>::readTrajectories(const V1 ps, M1 X) const {
+  /* pre-conditions */
+  BI_ASSERT(X.size1() == Xs.size2());
+  BI_ASSERT(ps.size() > 0 && X.size2() % ps.size() == 0);
+
+  typedef typename loc_temp_vector<CL,int>::type temp_int_vector_type;
+  typedef typename loc_temp_matrix<CL,real>::type temp_matrix_type;
+
+  const int K = ps.size();
+  const int T = X.size2()/K;
+  const host_int_vector_type& as1 = getHostAncestors();
+  temp_int_vector_type ps1(K), bs1(K);
+  host_int_vector_type bs(K), cs(K);
+  temp_matrix_type Z(K, Xs.size2());
+  int k, t;
+
+  /* leaves */
+  ps1 = ps;
+  bi::gather(ps1, ls, bs1);
+  bs = bs1;
+  synchronize(bs1.on_device);
+
+  /* leaves are all of the one generation, so all trajectories reach the
+   * root together */
+  t = T - 1;
+  do {
+    bs1 = bs;
+    bi::gather_rows(bs1, Xs, Z);
+    for (k = 0; k < K; ++k) {
+      column(X, k*T + t) = row(Z, k);
+    }
+    bi::gather(bs, as1, cs);
+    bs.swap(cs);
+    --t;
+  } while (bs(0) != -1);
+  synchronize(Z.on_device);
+}
+
 template<bi::Location CL>
 template<class B, bi::Location L, class V1>
 void bi::AncestryCache<CL>::writeState(const int t, const State<B,L>& s,
@@ -427,6 +510,7 @@ void bi::AncestryCache<CL>::writeState(const M1 X, const V1 as,
     }
     insert(X, as);
   }
+  asHostValid = false;
 #ifdef ENABLE_DIAGNOSTICS
   synchronize();
   usecs = clock.toc();
@@ -434,6 +518,26 @@ void bi::AncestryCache<CL>::writeState(const M1 X, const V1 as,
 #endif
 }
 
+template<bi::Location CL>
+inline const typename bi::AncestryCache<CL>::host_int_vector_type&
+    bi::AncestryCache<CL>::getHostAncestors() const {
+  if (!asHostValid) {
+    asHost.resize(as.size(), false);
+    asHost = as;
+    synchronize(as.on_device);
+    asHostValid = true;
+  }
+  return asHost;
+}
+
+namespace bi {
+template<>
+inline const AncestryCache<ON_HOST>::host_int_vector_type&
+    AncestryCache<ON_HOST>::getHostAncestors() const {
+  return as;
+}
+}
+
 template<bi::Location CL>
 void bi::AncestryCache<CL>::report() const {
   std::cerr << "AncestryCache: ";
@@ -462,6 +566,7 @@ void bi::AncestryCache<CL>::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, as);
   load_resizable_vector(ar, version, os);
   load_resizable_vector(ar, version, ls);
+  asHostValid = false;
   ar & m;
   ar & q;
   ar & usecs;
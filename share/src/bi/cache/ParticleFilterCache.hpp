@@ -97,6 +97,12 @@ public:
   template<class M1>
   void readTrajectory(const int p, M1 X) const;
 
+  /**
+   * @copydoc AncestryCache::readTrajectories()
+   */
+  template<class V1, class M1>
+  void readTrajectories(const V1 ps, M1 X) const;
+
   /**
    * Write-through to the underlying buffer, as well as efficient caching
    * of the ancestry using AncestryCache.
@@ -292,6 +298,13 @@ void bi::ParticleFilterCache<IO1,CL>::readTrajectory(const int p,
   ancestryCache.readTrajectory(p, X);
 }
 
+template<class IO1, bi::Location CL>
+template<class V1, class M1>
+void bi::ParticleFilterCache<IO1,CL>::readTrajectories(const V1 ps,
+    M1 X) const {
+  ancestryCache.readTrajectories(ps, X);
+}
+
 template<class IO1, bi::Location CL>
 template<class B, bi::Location L, class V1>
 void bi::ParticleFilterCache<IO1,CL>::writeState(const int t,
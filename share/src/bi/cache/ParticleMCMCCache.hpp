@@ -11,6 +11,7 @@
 #include "Cache1D.hpp"
 #include "CacheCross.hpp"
 #include "../buffer/ParticleMCMCNetCDFBuffer.hpp"
+#include "../misc/BackgroundThread.hpp"
 
 namespace bi {
 /**
@@ -18,6 +19,15 @@ namespace bi {
  *
  * @ingroup io_cache
  *
+ * When the cache is full, flushAsync() hands its contents to a dedicated
+ * writer thread and continues with an empty cache, so that sampling need
+ * not stop for output. The cache is double-buffered: at most one block of
+ * samples is being written while the next is filled, and flushAsync() waits
+ * for the write of the previous block before handing over the next, holding
+ * back the sampler when output falls behind. The writer thread is the only
+ * user of the output buffer while it runs; the output buffer should not be
+ * used other than through this cache.
+ *
  * @tparam IO1 Output type.
  * @tparam CL Location.
  */
@@ -162,10 +172,46 @@ public:
 
   /**
    * Flush to output buffer.
+   *
+   * Waits for any flush in the background to finish first.
    */
   void flush();
 
+  /**
+   * Flush to output buffer in the background, and clear cache.
+   *
+   * Waits for any previous flush in the background to finish first. Caches
+   * on device are flushed immediately instead.
+   */
+  void flushAsync();
+
+  /**
+   * Wait for any flush in the background to finish.
+   */
+  void sync() const;
+
 private:
+  /**
+   * Job to flush another cache.
+   */
+  class FlushJob: public BackgroundJob {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param cache Cache to flush.
+     */
+    FlushJob(ParticleMCMCCache<IO1,CL>* cache);
+
+    virtual void run();
+
+  private:
+    /**
+     * Cache to flush.
+     */
+    ParticleMCMCCache<IO1,CL>* cache;
+  };
+
   /**
    * Model.
    */
@@ -206,6 +252,22 @@ private:
    */
   IO1* out;
 
+  /**
+   * Back cache, holding the block being flushed in the background. Created
+   * on first use.
+   */
+  ParticleMCMCCache<IO1,CL>* back;
+
+  /**
+   * Job to flush back cache.
+   */
+  FlushJob* job;
+
+  /**
+   * Writer thread. Created on first use.
+   */
+  BackgroundThread* writer;
+
   /**
    * Maximum number of samples to store in cache.
    */
@@ -269,7 +331,8 @@ template<class IO1, bi::Location CL>
 template<class B>
 bi::ParticleMCMCCache<IO1,CL>::ParticleMCMCCache(B& m, IO1* out) : m(m),
     llCache(NUM_SAMPLES), lpCache(NUM_SAMPLES), parameterCache(NUM_SAMPLES,
-    m.getNetSize(P_VAR)), first(0), len(0), out(out) {
+    m.getNetSize(P_VAR)), first(0), len(0), out(out), back(NULL), job(NULL),
+    writer(NULL) {
   //
 }
 
@@ -281,7 +344,10 @@ bi::ParticleMCMCCache<IO1,CL>::ParticleMCMCCache(const ParticleMCMCCache<IO1,CL>
     parameterCache(o.parameterCache),
     first(o.first),
     len(o.len),
-    out(o.out) {
+    out(o.out),
+    back(NULL),
+    job(NULL),
+    writer(NULL) {
   trajectoryCache.resize(o.trajectoryCache.size());
   for (int i = 0; i < trajectoryCache.size(); ++i) {
     trajectoryCache[i] = new CacheCross<real,CL>(*o.trajectoryCache[i]);
@@ -291,6 +357,12 @@ bi::ParticleMCMCCache<IO1,CL>::ParticleMCMCCache(const ParticleMCMCCache<IO1,CL>
 template<class IO1, bi::Location CL>
 bi::ParticleMCMCCache<IO1,CL>::~ParticleMCMCCache() {
   flush();
+  delete writer;
+  delete job;
+  if (back != NULL) {
+    back->clear();  // already flushed
+    delete back;
+  }
   for (int t = 0; t < int(trajectoryCache.size()); ++t) {
     delete trajectoryCache[t];
   }
@@ -301,6 +373,7 @@ bi::ParticleMCMCCache<IO1,CL>& bi::ParticleMCMCCache<IO1,CL>::operator=(
     const ParticleMCMCCache<IO1,CL>& o) {
   m = o.m;
 
+  sync();
   empty();
   llCache = o.llCache;
   lpCache = o.lpCache;
@@ -324,6 +397,7 @@ void bi::ParticleMCMCCache<IO1,CL>::readTimes(const int t, V1 x) const {
   /* pre-condition */
   BI_ASSERT(out != NULL);
 
+  sync();
   out->readTimes(t, x);
 }
 
@@ -331,6 +405,7 @@ template<class IO1, bi::Location CL>
 template<class V1>
 void bi::ParticleMCMCCache<IO1,CL>::writeTimes(const int t, const V1 x) {
   if (out != NULL) {
+    sync();
     out->writeTimes(t, x);
   }
 }
@@ -484,6 +559,7 @@ void bi::ParticleMCMCCache<IO1,CL>::empty() {
 
 template<class IO1, bi::Location CL>
 void bi::ParticleMCMCCache<IO1,CL>::flush() {
+  sync();
   if (out != NULL) {
     out->writeLogLikelihoods(first, llCache.get(0, len));
     out->writeLogPriors(first, lpCache.get(0, len));
@@ -500,6 +576,44 @@ void bi::ParticleMCMCCache<IO1,CL>::flush() {
   }
 }
 
+template<class IO1, bi::Location CL>
+void bi::ParticleMCMCCache<IO1,CL>::flushAsync() {
+  if (out == NULL || CL == ON_DEVICE) {
+    flush();
+  } else {
+    if (writer == NULL) {
+      back = new ParticleMCMCCache<IO1,CL>(m, out);
+      job = new FlushJob(back);
+      writer = new BackgroundThread();
+    }
+
+    /* wait for the previous block, then hand over this one */
+    writer->wait();
+    back->clear();
+    swap(*back);
+    writer->submit(job);
+  }
+  clear();
+}
+
+template<class IO1, bi::Location CL>
+void bi::ParticleMCMCCache<IO1,CL>::sync() const {
+  if (writer != NULL) {
+    writer->wait();
+  }
+}
+
+template<class IO1, bi::Location CL>
+bi::ParticleMCMCCache<IO1,CL>::FlushJob::FlushJob(
+    ParticleMCMCCache<IO1,CL>* cache) : cache(cache) {
+  //
+}
+
+template<class IO1, bi::Location CL>
+void bi::ParticleMCMCCache<IO1,CL>::FlushJob::run() {
+  cache->flush();
+}
+
 template<class IO1, bi::Location CL>
 template<class Archive>
 void bi::ParticleMCMCCache<IO1,CL>::save(Archive& ar, const unsigned version) const {
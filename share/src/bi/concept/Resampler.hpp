@@ -105,6 +105,34 @@ struct Resampler {
   void resample(const int a, const V1& qlws, V2& lws, V3& as, O1& s)
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * Resample state of several independent groups of particles.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integral vector type.
+   * @tparam V3 Integral vector type.
+   * @tparam O1 Compatible copy() type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param[in,out] lws Log-weights, of all groups.
+   * @param[out] as Ancestry, of all groups.
+   * @param Ps Group offsets. Group @c g comprises particles <tt>Ps(g)</tt>
+   * to <tt>Ps(g + 1) - 1</tt>, so that @p Ps has one more element than
+   * there are groups, and its last element is the total number of
+   * particles.
+   * @param[in,out] s State, of all groups.
+   *
+   * Each group is resampled independently, with its own number of
+   * particles, as if by resample() on that group alone. Ancestors are
+   * indices into @p lws, so always fall within the same group. Groups are
+   * processed in parallel, with no temporary allocation per group.
+   *
+   * The weights @p lws are set to be uniform after the resampling.
+   */
+  template<class V1, class V2, class V3, class O1>
+  void seg_resample(Random& rng, V1 lws, V2 as, const V3 Ps, O1& s)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * Select ancestors.
    *
@@ -119,6 +147,22 @@ struct Resampler {
   void ancestors(Random& rng, const V1 lws, V2 as)
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * Select ancestors for several independent groups of particles.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights, of all groups.
+   * @param[out] as Ancestors, of all groups.
+   * @param Ps Group offsets, as for seg_resample().
+   */
+  template<class V1, class V2, class V3>
+  void ancestors(Random& rng, const V1 lws, V2 as, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * Select offspring.
    *
@@ -134,5 +178,22 @@ struct Resampler {
   void offspring(Random& rng, const V1 lws, V2 os, const int P);
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * Select offspring for several independent groups of particles.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights, of all groups.
+   * @param[out] os Offspring, of all groups.
+   * @param Ps Group offsets, as for seg_resample(). The total number of
+   * offspring of each group is its number of particles.
+   */
+  template<class V1, class V2, class V3>
+  void offspring(Random& rng, const V1 lws, V2 os, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
+
 };
 }
@@ -10,24 +10,26 @@
 
 #include "DOPRI5KernelGPU.cuh"
 #include "../cuda.hpp"
+#include "../../ode/IntegratorConfig.hpp"
 
 namespace bi {
 /**
  * @copydoc DOPRI5Integrator
  */
-template<class B, class S, class T1>
+template<class B, class S, class XH, class XT, class T1>
 class DOPRI5IntegratorGPU {
 public:
   /**
    * @copydoc DOPRI5Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_DEVICE>& s);
 };
 }
 
-template<class B, class S, class T1>
-void bi::DOPRI5IntegratorGPU<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE>& s) {
+template<class B, class S, class XH, class XT, class T1>
+void bi::DOPRI5IntegratorGPU<B,S,XH,XT,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_DEVICE>& s) {
   static const int N = block_size<S>::value;
   if (N > 0) {
     /* execution config */
@@ -51,7 +53,7 @@ void bi::DOPRI5IntegratorGPU<B,S,T1>::update(const T1 t1, const T1 t2,
         Db.x << " for CUDA ODE integrator");
 
     /* launch */
-    kernelDOPRI5<B,S,T1><<<Dg,Db,Ns>>>(t1, t2, s);
+    kernelDOPRI5<B,S,XH,XT,T1><<<Dg,Db,Ns>>>(cfg, t1, t2, s);
     CUDA_CHECK;
   }
 }
@@ -9,31 +9,37 @@
 #define BI_CUDA_ODE_DOPRI5KERNELGPU_CUH
 
 #include "../cuda.hpp"
+#include "../../ode/IntegratorConfig.hpp"
 
 namespace bi {
 /**
  * Kernel function for DOPRI5IntegratorGPU.
  *
  * @tparam B Model type.
+ * @tparam S Action type list.
+ * @tparam XH Variable type in which to carry step size between calls.
+ * @tparam XT Variable type in which to carry time between calls.
+ * @tparam T1 Scalar type.
  *
+ * @param cfg Integrator configuration.
  * @param t1 Current time.
  * @param t2 Time to which to integrate.
  * @param[in,out] s State.
  */
-template<class B, class S, class T1>
-CUDA_FUNC_GLOBAL void kernelDOPRI5(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE> s);
+template<class B, class S, class XH, class XT, class T1>
+CUDA_FUNC_GLOBAL void kernelDOPRI5(const IntegratorConfig cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE> s);
 
 }
 
 #include "DOPRI5VisitorGPU.cuh"
-#include "IntegratorConstants.cuh"
 #include "../constant.cuh"
 #include "../shared.cuh"
 #include "../global.cuh"
 
-template<class B, class S, class T1>
-CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const T1 t1, const T1 t2, State<B,ON_DEVICE> s) {
+template<class B, class S, class XH, class XT, class T1>
+CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const IntegratorConfig cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE> s) {
   typedef Pa<ON_DEVICE,B,global,global,global,global> PX;
   typedef DOPRI5VisitorGPU<B,S,S,real,PX,real> Visitor;
 
@@ -59,6 +65,7 @@ CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const T1 t1, const T1 t2, State<B,ON_DEVI
   real& h = hs[q];
   real& e2 = e2s[q];
   real& logfacold = logfacolds[q];
+  real hn; // step size to carry, used by head thread only
   PX pax;
 
   /* flags */
@@ -68,7 +75,13 @@ CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const T1 t1, const T1 t2, State<B,ON_DEVI
   /* initialise */
   if (headOfTraj) {
     t = t1;
-    h = h0;
+    h = cfg.h0;
+    if (s.template getVar<XT>(p, 0) == t1 &&
+        s.template getVar<XH>(p, 0) > BI_REAL(0.0)) {
+      /* resume with step size of last call, which stopped at t1 */
+      h = s.template getVar<XH>(p, 0);
+    }
+    hn = h;
     logfacold = bi::exp(BI_REAL(1.0e-4));
   }
   __syncthreads();
@@ -81,8 +94,11 @@ CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const T1 t1, const T1 t2, State<B,ON_DEVI
   x0 = x;
 
   do {
-    if (headOfTraj && t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
-      h = t2 - t;
+    if (headOfTraj) {
+      hn = h;
+      if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
+        h = t2 - t;
+      }
     }
     __syncthreads();
 
@@ -121,7 +137,7 @@ CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const T1 t1, const T1 t2, State<B,ON_DEVI
     /* compute error */
     Visitor::stageErr(t, h, s, p, i, pax, x0, x6, k7, err);
     err *= h;
-    err /= atoler + rtoler*bi::max(bi::abs(x0), bi::abs(x6));
+    err /= cfg.atoler + cfg.rtoler*bi::max(bi::abs(x0), bi::abs(x6));
 
     /* sum squared errors */
     /* have tried a spin lock here instead, using atomicCAS(), with slightly
@@ -154,15 +170,20 @@ CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const T1 t1, const T1 t2, State<B,ON_DEVI
       e2 *= BI_REAL(1.0)/BI_REAL(N);
 
       /* compute next step size */
-      real logfac11 = expo*bi::log(e2);
+      real logfac11 = cfg.expo*bi::log(e2);
       if (e2 > BI_REAL(1.0)) {
         /* step was rejected */
-        h *= bi::max(facl, bi::exp(logsafe - logfac11));
+        h *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11));
       } else {
         /* step was accepted */
         t += h; // slightly faster to do this here, saves headOfTraj check
-        h *= bi::min(facr, bi::max(facl, bi::exp(::beta*logfacold + logsafe - logfac11))); // bound
+        h *= bi::min(cfg.facr, bi::max(cfg.facl, bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11))); // bound
         logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
+        if (t >= t2) {
+          /* finished, carry the larger of the step sizes proposed before
+           * truncation at t2 and after the last step */
+          hn = bi::max(hn, h);
+        }
       }
     }
 
@@ -176,7 +197,12 @@ CUDA_FUNC_GLOBAL void bi::kernelDOPRI5(const T1 t1, const T1 t2, State<B,ON_DEVI
     __syncthreads();
 
     ++n;
-  } while (!done && n < nsteps);
+  } while (!done && n < cfg.nsteps);
+
+  if (headOfTraj) {
+    s.template getVar<XH>(p, 0) = hn;
+    s.template getVar<XT>(p, 0) = t;
+  }
 }
 
 #endif
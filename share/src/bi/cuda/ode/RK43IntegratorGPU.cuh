@@ -10,6 +10,7 @@
 
 #include "RK43KernelGPU.cuh"
 #include "../cuda.hpp"
+#include "../../ode/IntegratorConfig.hpp"
 
 namespace bi {
 /**
@@ -21,13 +22,14 @@ public:
   /**
    * @copydoc RK43Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_DEVICE>& s);
 };
 }
 
 template<class B, class S, class T1>
-void bi::RK43IntegratorGPU<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE>& s) {
+void bi::RK43IntegratorGPU<B,S,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_DEVICE>& s) {
   static const int N = block_size<S>::value;
   static const int ND = B::ND;
 
@@ -53,7 +55,7 @@ void bi::RK43IntegratorGPU<B,S,T1>::update(const T1 t1, const T1 t2,
         Db.x << " for CUDA ODE integrator");
 
     /* launch */
-    kernelRK43<B,S,T1><<<Dg,Db,Ns>>>(t1, t2, s);
+    kernelRK43<B,S,T1><<<Dg,Db,Ns>>>(cfg, t1, t2, s);
     CUDA_CHECK;
   }
 }
@@ -9,6 +9,7 @@
 #define BI_CUDA_ODE_RK43KERNELGPU_CUH
 
 #include "../cuda.hpp"
+#include "../../ode/IntegratorConfig.hpp"
 
 namespace bi {
 /**
@@ -16,24 +17,25 @@ namespace bi {
  *
  * @tparam B Model type.
  *
+ * @param cfg Integrator configuration.
  * @param t1 Current time.
  * @param t2 Time to which to integrate.
  * @param[in,out] s State.
  */
 template<class B, class S, class T1>
-CUDA_FUNC_GLOBAL void kernelRK43(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE> s);
+CUDA_FUNC_GLOBAL void kernelRK43(const IntegratorConfig cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE> s);
 
 }
 
 #include "RK43VisitorGPU.cuh"
-#include "IntegratorConstants.cuh"
 #include "../constant.cuh"
 #include "../shared.cuh"
 #include "../global.cuh"
 
 template<class B, class S, class T1>
-CUDA_FUNC_GLOBAL void bi::kernelRK43(const T1 t1, const T1 t2, State<B,ON_DEVICE> s) {
+CUDA_FUNC_GLOBAL void bi::kernelRK43(const IntegratorConfig cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE> s) {
   typedef Pa<ON_DEVICE,B,global,global,global,global> PX;
   typedef RK43VisitorGPU<B,S,S,real,PX,real> Visitor;
 
@@ -68,7 +70,7 @@ CUDA_FUNC_GLOBAL void bi::kernelRK43(const T1 t1, const T1 t2, State<B,ON_DEVICE
   /* initialise */
   if (headOfTraj) {
     t = t1;
-    h = h0;
+    h = cfg.h0;
     logfacold = bi::log(BI_REAL(1.0e-4));
   }
   __syncthreads();
@@ -113,7 +115,7 @@ CUDA_FUNC_GLOBAL void bi::kernelRK43(const T1 t1, const T1 t2, State<B,ON_DEVICE
     __syncthreads();
 
     err *= h;
-    err /= atoler + rtoler*bi::max(bi::abs(old), bi::abs(r1));
+    err /= cfg.atoler + cfg.rtoler*bi::max(bi::abs(old), bi::abs(r1));
 
     /* sum squared errors */
     /* have tried a spin lock here instead, using atomicCAS(), with slightly
@@ -145,14 +147,14 @@ CUDA_FUNC_GLOBAL void bi::kernelRK43(const T1 t1, const T1 t2, State<B,ON_DEVICE
       e2 *= BI_REAL(1.0)/BI_REAL(N);
 
       /* compute next step size */
-      real logfac11 = expo*bi::log(e2);
+      real logfac11 = cfg.expo*bi::log(e2);
       if (e2 > BI_REAL(1.0)) {
         /* step was rejected */
-        h *= bi::max(facl, bi::exp(logsafe - logfac11));
+        h *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11));
       } else {
         /* step was accepted */
         t += h; // slightly faster to do this here, saves headOfTraj check
-        h *= bi::min(facr, bi::max(facl, bi::exp(::beta*logfacold + logsafe - logfac11))); // bound
+        h *= bi::min(cfg.facr, bi::max(cfg.facl, bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11))); // bound
         logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
       }
     }
@@ -167,7 +169,7 @@ CUDA_FUNC_GLOBAL void bi::kernelRK43(const T1 t1, const T1 t2, State<B,ON_DEVICE
     __syncthreads();
 
     ++n;
-  } while (!done && n < nsteps);
+  } while (!done && n < cfg.nsteps);
 }
 
 #endif
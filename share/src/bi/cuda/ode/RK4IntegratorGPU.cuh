@@ -10,6 +10,7 @@
 
 #include "RK4KernelGPU.cuh"
 #include "../cuda.hpp"
+#include "../../ode/IntegratorConfig.hpp"
 
 namespace bi {
 /**
@@ -21,13 +22,14 @@ public:
   /**
    * @copydoc RK4Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_DEVICE>& s);
 };
 }
 
 template<class B, class S, class T1>
-void bi::RK4IntegratorGPU<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE>& s) {
+void bi::RK4IntegratorGPU<B,S,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_DEVICE>& s) {
   static const int N = block_size<S>::value;
   if (N > 0) {
     /* execution config */
@@ -49,7 +51,7 @@ void bi::RK4IntegratorGPU<B,S,T1>::update(const T1 t1, const T1 t2,
         Db.x << " for CUDA ODE integrator");
 
     /* launch */
-    kernelRK4<B,S,T1><<<Dg,Db,Ns>>>(t1, t2, s);
+    kernelRK4<B,S,T1><<<Dg,Db,Ns>>>(cfg, t1, t2, s);
     CUDA_CHECK;
   }
 }
@@ -9,6 +9,7 @@
 #define BI_CUDA_ODE_RK4KERNELGPU_CUH
 
 #include "../cuda.hpp"
+#include "../../ode/IntegratorConfig.hpp"
 
 namespace bi {
 /**
@@ -16,25 +17,25 @@ namespace bi {
  *
  * @tparam B Model type.
  *
+ * @param cfg Integrator configuration.
  * @param t1 Current time.
  * @param t2 Time to which to integrate.
  * @param[in,out] s State.
  */
 template<class B, class S, class T1>
-CUDA_FUNC_GLOBAL void kernelRK4(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE> s);
+CUDA_FUNC_GLOBAL void kernelRK4(const IntegratorConfig cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE> s);
 
 }
 
 #include "RK4VisitorGPU.cuh"
-#include "IntegratorConstants.cuh"
 #include "../constant.cuh"
 #include "../shared.cuh"
 #include "../global.cuh"
 
 template<class B, class S, class T1>
-CUDA_FUNC_GLOBAL void bi::kernelRK4(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE> s) {
+CUDA_FUNC_GLOBAL void bi::kernelRK4(const IntegratorConfig cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE> s) {
   typedef Pa<ON_DEVICE,B,global,global,global,global> PX;
   typedef RK4VisitorGPU<B,S,S,real,PX,real> Visitor;
 
@@ -47,7 +48,7 @@ CUDA_FUNC_GLOBAL void bi::kernelRK4(const T1 t1, const T1 t2,
   PX pax;
 
   /* initialise */
-  real t = t1, h = h0, x0 = x, x1, x2, x3, x4;
+  real t = t1, h = cfg.h0, x0 = x, x1, x2, x3, x4;
   __syncthreads();
 
   while (t < t2) {
@@ -9,6 +9,16 @@
 #define BI_HOST_CACHE_ANCESTRYCACHEHOST_HPP
 
 namespace bi {
+/**
+ * Host implementation of AncestryCache operations.
+ *
+ * Both operations are multithreaded. Pruning walks up the tree from each
+ * leaf in parallel, decrementing offspring counts atomically, so that the
+ * one thread to reduce a count to zero continues the walk. Insertion finds
+ * free slots with a parallel prefix scan over the storage, in next-fit
+ * order, so that slots are allocated exactly as a sequential next-fit
+ * search would.
+ */
 class AncestryCacheHost {
 public:
   /**
@@ -54,22 +64,33 @@ public:
 #include "../../math/view.hpp"
 #include "../../primitive/vector_primitive.hpp"
 #include "../../primitive/matrix_primitive.hpp"
+#include "../../misc/omp.hpp"
 
 template<class V1>
 int bi::AncestryCacheHost::prune(V1 as, V1 os, V1 ls) {
   /* pre-condition */
   assert(!V1::on_device);
 
-  int i, j, numRemoved = 0;
-  for (i = 0; i < ls.size(); ++i) {
-    j = ls(i);
-    while (os(j) == 0) {
-      ++numRemoved;
-      j = as(j);
-      if (j >= 0) {
-        --os(j);
-      } else {
-        break;
+  const int N = ls.size();
+  int numRemoved = 0;
+
+  #pragma omp parallel reduction(+:numRemoved)
+  {
+    int i, j, o;
+
+    #pragma omp for
+    for (i = 0; i < N; ++i) {
+      j = ls(i);
+      o = os(j);
+      while (o == 0) {
+        ++numRemoved;
+        j = as(j);
+        if (j >= 0) {
+          #pragma omp atomic capture
+          o = --os(j);
+        } else {
+          break;
+        }
       }
     }
   }
@@ -85,23 +106,63 @@ int bi::AncestryCacheHost::insert(M1 X, V1 as, V1 os, V1 ls, const int start,
   typedef typename temp_host_vector<int>::type host_int_vector_type;
 
   const int N = X1.size1();
-  host_int_vector_type bs(N);
-  int i, q = start;
+  const int S = X.size1();
+  const int T = bi_omp_max_threads;
+  host_int_vector_type bs(N), counts(T + 1);
+  int q = start;
 
   bi::gather(as1, ls, bs);
   ls.resize(N, false);
 
-  for (i = 0; i < N; ++i) {
-    while (os(q) > 0) {
-      ++q;
-      if (q == X.size1()) {
-        q = 0;
+  /* the storage is split into T contiguous blocks, in next-fit order from
+   * start, i.e. position k in this order is slot (start + k) % S; blocks
+   * are distributed over threads statically, whatever the size of the
+   * team */
+  #pragma omp parallel
+  {
+    int b, j, k, k1, k2, n;
+
+    /* count free slots in each block */
+    #pragma omp for schedule(static)
+    for (b = 0; b < T; ++b) {
+      k1 = static_cast<int>(static_cast<long>(S)*b/T);
+      k2 = static_cast<int>(static_cast<long>(S)*(b + 1)/T);
+      n = 0;
+      for (k = k1; k < k2; ++k) {
+        j = (start + k < S) ? start + k : start + k - S;
+        if (os(j) == 0) {
+          ++n;
+        }
       }
+      counts(b + 1) = n;
     }
-    ls(i) = q;
-    ++q;
-    if (q == X.size1()) {
-      q = 0;
+
+    /* exclusive scan of counts gives first allocation of each block */
+    #pragma omp single
+    {
+      counts(0) = 0;
+      for (b = 1; b <= T; ++b) {
+        counts(b) += counts(b - 1);
+      }
+    }
+
+    /* allocate free slots in each block */
+    #pragma omp for schedule(static)
+    for (b = 0; b < T; ++b) {
+      k1 = static_cast<int>(static_cast<long>(S)*b/T);
+      k2 = static_cast<int>(static_cast<long>(S)*(b + 1)/T);
+      n = counts(b);
+      for (k = k1; k < k2 && n < N; ++k) {
+        j = (start + k < S) ? start + k : start + k - S;
+        if (os(j) == 0) {
+          ls(n) = j;
+          ++n;
+          if (n == N) {
+            /* only one block allocates the last slot */
+            q = (j + 1 < S) ? j + 1 : 0;
+          }
+        }
+      }
     }
   }
 
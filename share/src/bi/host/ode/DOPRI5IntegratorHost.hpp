@@ -8,6 +8,29 @@
 #ifndef BI_HOST_ODE_DOPRI5INTEGRATORHOST_HPP
 #define BI_HOST_ODE_DOPRI5INTEGRATORHOST_HPP
 
+#include "../../ode/IntegratorConfig.hpp"
+
+/**
+ * @def BI_ODE_TILE_SIZE
+ *
+ * Maximum number of trajectories integrated together by
+ * DOPRI5IntegratorHost.
+ */
+#ifndef BI_ODE_TILE_SIZE
+#define BI_ODE_TILE_SIZE 64
+#endif
+
+/**
+ * @def BI_ODE_TILE_BYTES
+ *
+ * Maximum size, in bytes, of the stage buffers of a tile of trajectories in
+ * DOPRI5IntegratorHost. Tiles are made smaller than #BI_ODE_TILE_SIZE
+ * trajectories for large models, so that the buffers stay in cache.
+ */
+#ifndef BI_ODE_TILE_BYTES
+#define BI_ODE_TILE_BYTES 262144
+#endif
+
 namespace bi {
 /**
  * Dormand-Prince 5(4) integrator.
@@ -16,24 +39,52 @@ namespace bi {
  *
  * @tparam B Model type.
  * @tparam S Action type list.
+ * @tparam XH Variable type in which to carry step size between calls.
+ * @tparam XT Variable type in which to carry time between calls.
  * @tparam T1 Scalar type.
+ *
+ * Trajectories are integrated in tiles, each with its own step size. Stage
+ * buffers are kept for the whole tile in structure-of-arrays layout, and
+ * actions read the variables of the block from these rather than from the
+ * state, which is written only once integration of the tile is complete.
+ * If IntegratorConfig::tiled is false, trajectories are instead integrated
+ * one at a time, with the state written after each stage.
  */
-template<class B, class S, class T1>
+template<class B, class S, class XH, class XT, class T1>
 class DOPRI5IntegratorHost {
 public:
   /**
    * Integrate.
    *
+   * @param cfg Integrator configuration.
    * @param t1 Start of time interval.
    * @param t2 End of time interval.
    * @param[in,out] s State.
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+  /**
+   * Integrate in tiles.
+   *
+   * @copydetails update()
+   */
+  static void updateTiled(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+  /**
+   * Integrate one trajectory at a time.
+   *
+   * @copydetails update()
+   */
+  static void updateUntiled(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
+#include "DOPRI5TileVisitorHost.hpp"
 #include "DOPRI5VisitorHost.hpp"
-#include "IntegratorConstants.hpp"
+#include "PaTileHost.hpp"
 #include "../host.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
@@ -41,8 +92,189 @@ public:
 #include "../../traits/block_traits.hpp"
 #include "../../math/view.hpp"
 
-template<class B, class S, class T1>
-void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
+#include <vector>
+#include <algorithm>
+
+template<class B, class S, class XH, class XT, class T1>
+void bi::DOPRI5IntegratorHost<B,S,XH,XT,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
+  if (cfg.tiled) {
+    updateTiled(cfg, t1, t2, s);
+  } else {
+    updateUntiled(cfg, t1, t2, s);
+  }
+}
+
+template<class B, class S, class XH, class XT, class T1>
+void bi::DOPRI5IntegratorHost<B,S,XH,XT,T1>::updateTiled(
+    const IntegratorConfig& cfg, const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  typedef host_vector_reference<real> vector_reference_type;
+  static const int N = block_size<S>::value;
+  static const int T0 = BI_ODE_TILE_BYTES/(10*N*sizeof(real));
+  static const int T = (T0 < 1) ? 1 : ((T0 > BI_ODE_TILE_SIZE) ?
+      BI_ODE_TILE_SIZE : T0); // trajectories per tile
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef PaTileHost<B,S,PX,T> TX;
+  typedef DOPRI5TileVisitorHost<B,S,S,real,TX,real,T> Visitor;
+
+  const int P = s.size();
+
+  /* map from d-net to block components, for reading parents from tiles */
+  std::vector<int> ids(B::ND + 1, -1);
+  Visitor::map(&ids[0]);
+
+  #pragma omp parallel
+  {
+    /* tile buffers, allocated once per thread, as too large for stack */
+    std::vector<real> buf(10*N*T + 5*T);
+    std::vector<int> n(T);
+    std::vector<char> accept(T);
+    real *x0 = &buf[0], *x1 = x0 + N*T, *x2 = x0 + 2*N*T, *x3 = x0 + 3*N*T,
+        *x4 = x0 + 4*N*T, *x5 = x0 + 5*N*T, *x6 = x0 + 6*N*T,
+        *err = x0 + 7*N*T, *k1 = x0 + 8*N*T, *k7 = x0 + 9*N*T;
+    real *t = x0 + 10*N*T, *h = t + T, *hn = h + T, *e2 = hn + T,
+        *logfacold = e2 + T;
+
+    real e, logfac11, fac;
+    int id, j, m, p, nactive, naccept;
+    bool k1in;
+    TX pax(&ids[0]);
+
+    #pragma omp for
+    for (p = 0; p < P; p += T) {
+      m = bi::min(T, P - p);
+      for (j = 0; j < m; ++j) {
+        t[j] = t1;
+        h[j] = cfg.h0;
+        if (s.template getVar<XT>(p + j, 0) == t1 &&
+            s.template getVar<XH>(p + j, 0) > BI_REAL(0.0)) {
+          /* resume with step size of last call, which stopped at t1 */
+          h[j] = s.template getVar<XH>(p + j, 0);
+        }
+        hn[j] = h[j];
+        logfacold[j] = bi::log(BI_REAL(1.0e-4));
+        n[j] = 0;
+        host_load<B,S>(s, p + j, vector_reference_type(x0 + j, N, T));
+      }
+      pax.p0 = p;
+      k1in = false;
+      nactive = m;
+
+      /* integrate */
+      while (nactive > 0) {
+        for (j = 0; j < m; ++j) {
+          if (t[j] < t2 && n[j] < cfg.nsteps) {
+            hn[j] = h[j]; // step size to carry, before truncation at t2
+            if (t[j] + BI_REAL(1.01)*h[j] - t2 > BI_REAL(0.0)) {
+              h[j] = t2 - t[j];
+            }
+          } else {
+            h[j] = BI_REAL(0.0); // finished, idle until rest of tile finishes
+          }
+        }
+
+        /* stages, each reading the variables of the block from the last */
+        pax.x = x0;
+        Visitor::stage1(t, h, s, p, m, pax, x0, x1, x2, x3, x4, x5, x6, k1, err, k1in);
+        k1in = true; // can reuse from previous iteration in future
+
+        pax.x = x1;
+        Visitor::stage2(t, h, s, p, m, pax, x0, x2, x3, x4, x5, x6, err);
+
+        pax.x = x2;
+        Visitor::stage3(t, h, s, p, m, pax, x0, x3, x4, x5, x6, err);
+
+        pax.x = x3;
+        Visitor::stage4(t, h, s, p, m, pax, x0, x4, x5, x6, err);
+
+        pax.x = x4;
+        Visitor::stage5(t, h, s, p, m, pax, x0, x5, x6, err);
+
+        pax.x = x5;
+        Visitor::stage6(t, h, s, p, m, pax, x0, x6, err);
+
+        /* compute error */
+        pax.x = x6;
+        Visitor::stageErr(t, h, s, p, m, pax, x0, x6, k7, err);
+        for (j = 0; j < m; ++j) {
+          e2[j] = BI_REAL(0.0);
+        }
+        for (id = 0; id < N; ++id) {
+          for (j = 0; j < m; ++j) {
+            e = err[id*T + j]*h[j]/(cfg.atoler + cfg.rtoler*bi::max(bi::abs(x0[id*T + j]), bi::abs(x6[id*T + j])));
+            e2[j] += e*e;
+          }
+        }
+
+        /* accept/reject */
+        naccept = 0;
+        for (j = 0; j < m; ++j) {
+          e2[j] /= N;
+          accept[j] = h[j] > BI_REAL(0.0) && e2[j] <= BI_REAL(1.0);
+          if (accept[j]) {
+            t[j] += h[j];
+            ++naccept;
+          }
+        }
+        if (naccept == m) {
+          std::swap(x0, x6);
+          std::swap(k1, k7);
+        } else if (naccept > 0) {
+          for (id = 0; id < N; ++id) {
+            for (j = 0; j < m; ++j) {
+              if (accept[j]) {
+                x0[id*T + j] = x6[id*T + j];
+                k1[id*T + j] = k7[id*T + j];
+              }
+            }
+          }
+        }
+
+        /* compute next step size */
+        nactive = 0;
+        for (j = 0; j < m; ++j) {
+          if (h[j] > BI_REAL(0.0)) {
+            logfac11 = cfg.expo*bi::log(e2[j]);
+            if (!accept[j]) {
+              /* step was rejected */
+              h[j] *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11));
+            } else {
+              /* step was accepted */
+              fac = bi::exp(cfg.beta*logfacold[j] + cfg.logsafe - logfac11); // Lund-stabilization
+              fac = bi::min(cfg.facr, bi::max(cfg.facl, fac));  // bound
+              h[j] *= fac;
+              logfacold[j] = BI_REAL(0.5)*bi::log(bi::max(e2[j], BI_REAL(1.0e-8)));
+              if (t[j] >= t2) {
+                /* finished, carry the larger of the step sizes proposed
+                 * before truncation at t2 and after the last step */
+                hn[j] = bi::max(hn[j], h[j]);
+              }
+            }
+            ++n[j];
+          }
+          if (t[j] < t2 && n[j] < cfg.nsteps) {
+            ++nactive;
+          }
+        }
+      }
+
+      /* write back */
+      for (j = 0; j < m; ++j) {
+        host_store<B,S>(s, p + j, vector_reference_type(x0 + j, N, T));
+        s.template getVar<XH>(p + j, 0) = hn[j];
+        s.template getVar<XT>(p + j, 0) = t[j];
+      }
+    }
+  }
+}
+
+template<class B, class S, class XH, class XT, class T1>
+void bi::DOPRI5IntegratorHost<B,S,XH,XT,T1>::updateUntiled(
+    const IntegratorConfig& cfg, const T1 t1, const T1 t2,
     State<B,ON_HOST>& s) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
@@ -56,19 +288,19 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
 
   #pragma omp parallel
   {
-    real buf[10*N]; // use of dynamic array faster than heap allocation
-    vector_reference_type x0(buf, N);
-    vector_reference_type x1(buf + N, N);
-    vector_reference_type x2(buf + 2*N, N);
-    vector_reference_type x3(buf + 3*N, N);
-    vector_reference_type x4(buf + 4*N, N);
-    vector_reference_type x5(buf + 5*N, N);
-    vector_reference_type x6(buf + 6*N, N);
-    vector_reference_type err(buf + 7*N, N);
-    vector_reference_type k1(buf + 8*N, N);
-    vector_reference_type k7(buf + 9*N, N);
-
-    real t, h, e, e2, logfacold, logfac11, fac;
+    std::vector<real> buf(10*N);
+    vector_reference_type x0(&buf[0], N);
+    vector_reference_type x1(&buf[N], N);
+    vector_reference_type x2(&buf[2*N], N);
+    vector_reference_type x3(&buf[3*N], N);
+    vector_reference_type x4(&buf[4*N], N);
+    vector_reference_type x5(&buf[5*N], N);
+    vector_reference_type x6(&buf[6*N], N);
+    vector_reference_type err(&buf[7*N], N);
+    vector_reference_type k1(&buf[8*N], N);
+    vector_reference_type k7(&buf[9*N], N);
+
+    real t, h, hn, e, e2, logfacold, logfac11, fac;
     int n, id, p;
     bool k1in;
     PX pax;
@@ -76,26 +308,26 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
     #pragma omp for
     for (p = 0; p < P; ++p) {
       t = t1;
-      h = h_h0;
+      h = cfg.h0;
+      if (s.template getVar<XT>(p, 0) == t1 &&
+          s.template getVar<XH>(p, 0) > BI_REAL(0.0)) {
+        /* resume with step size of last call, which stopped at t1 */
+        h = s.template getVar<XH>(p, 0);
+      }
+      hn = h;
       logfacold = bi::log(BI_REAL(1.0e-4));
       k1in = false;
       n = 0;
       host_load<B,S>(s, p, x0);
 
       /* integrate */
-      while (t < t2 && n < h_nsteps) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
-          // step size too small
-        }
+      while (t < t2 && n < cfg.nsteps) {
+        hn = h; // step size to carry, before truncation at t2
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
           h = t2 - t;
-          if (h <= BI_REAL(0.0)) {
-            t = t2;
-            break;
-          }
         }
 
-        /* stages */
+        /* stages, each reading the variables of the block from the state */
         Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), k1.buf(), err.buf(), k1in);
         k1in = true; // can reuse from previous iteration in future
         host_store<B,S>(s, p, x1);
@@ -113,19 +345,19 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
         host_store<B,S>(s, p, x5);
 
         Visitor::stage6(t, h, s, p, pax, x0.buf(), x6.buf(), err.buf());
+        host_store<B,S>(s, p, x6);
 
         /* compute error */
         Visitor::stageErr(t, h, s, p, pax, x0.buf(), x6.buf(), k7.buf(), err.buf());
-        e2 = 0.0;
+        e2 = BI_REAL(0.0);
         for (id = 0; id < N; ++id) {
-          e = err(id)*h/(h_atoler + h_rtoler*bi::max(bi::abs(x0(id)), bi::abs(x6(id))));
+          e = err(id)*h/(cfg.atoler + cfg.rtoler*bi::max(bi::abs(x0(id)), bi::abs(x6(id))));
           e2 += e*e;
         }
         e2 /= N;
 
         /* accept/reject */
         if (e2 <= BI_REAL(1.0)) {
-          /* accept */
           t += h;
           x0.swap(x6);
           k1.swap(k7);
@@ -133,22 +365,26 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
         host_store<B,S>(s, p, x0);
 
         /* compute next step size */
-        if (t < t2) {
-          logfac11 = h_expo*bi::log(e2);
-          if (e2 > BI_REAL(1.0)) {
-            /* step was rejected */
-            h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
-          } else {
-            /* step was accepted */
-            fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11); // Lund-stabilization
-            fac = bi::min(h_facr, bi::max(h_facl, fac));  // bound
-            h *= fac;
-            logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
+        logfac11 = cfg.expo*bi::log(e2);
+        if (e2 > BI_REAL(1.0)) {
+          /* step was rejected */
+          h *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11));
+        } else {
+          /* step was accepted */
+          fac = bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11); // Lund-stabilization
+          fac = bi::min(cfg.facr, bi::max(cfg.facl, fac));  // bound
+          h *= fac;
+          logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
+          if (t >= t2) {
+            /* finished, carry the larger of the step sizes proposed
+             * before truncation at t2 and after the last step */
+            hn = bi::max(hn, h);
           }
         }
-
         ++n;
       }
+      s.template getVar<XH>(p, 0) = hn;
+      s.template getVar<XT>(p, 0) = t;
     }
   }
 }
@@ -0,0 +1,248 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_DOPRI5TILEVISITORHOST_HPP
+#define BI_HOST_ODE_DOPRI5TILEVISITORHOST_HPP
+
+#include "../../ode/DOPRI5Stage.hpp"
+
+namespace bi {
+/**
+ * Visitor for DOPRI5IntegratorHost, over a tile of trajectories.
+ *
+ * @tparam B Model type.
+ * @tparam S1 Action type list.
+ * @tparam S2 Action type list.
+ * @tparam T1 Scalar type.
+ * @tparam PX Parents type.
+ * @tparam T2 Scalar type.
+ * @tparam T Number of trajectories in tile.
+ *
+ * Buffers are in structure-of-arrays layout, with component @c id of
+ * trajectory <tt>p + j</tt> at <tt>[id*T + j]</tt>. Each stage visits the
+ * @c n trajectories of the tile for one component before moving to the
+ * next. @p t and @p h give the time and step size of each trajectory.
+ */
+template<class B, class S1, class S2, class T1, class PX, class T2, int T>
+class DOPRI5TileVisitorHost {
+public:
+  /**
+   * Map each index of the d-net to the component of the block that updates
+   * it.
+   *
+   * @param[out] ids Map, entries not updated by the block are untouched.
+   */
+  static void map(int* ids) {
+    coord_type cox;
+    int id = start;
+
+    while (id < end) {
+      if (is_d_var<target_type>::value) {
+        ids[var_start<target_type>::value + cox.index()] = id;
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::map(ids);
+  }
+
+  static void stage1(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x1, T2* x2,
+      T2* x3, T2* x4, T2* x5, T2* x6, T2* k1, T2* err,
+      const bool k1in = false) {
+    coord_type cox;
+    int id = start, j;
+
+    while (id < end) {
+      for (j = 0; j < n; ++j) {
+        stage::stage1(t[j], h[j], s, p + j, cox, pax, x0[id*T + j],
+            x1[id*T + j], x2[id*T + j], x3[id*T + j], x4[id*T + j],
+            x5[id*T + j], x6[id*T + j], k1[id*T + j], err[id*T + j], k1in);
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::stage1(t, h, s, p, n, pax, x0, x1, x2, x3, x4, x5, x6, k1, err,
+        k1in);
+  }
+
+  static void stage2(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x2, T2* x3,
+      T2* x4, T2* x5, T2* x6, T2* err) {
+    coord_type cox;
+    int id = start, j;
+
+    while (id < end) {
+      for (j = 0; j < n; ++j) {
+        stage::stage2(t[j], h[j], s, p + j, cox, pax, x0[id*T + j],
+            x2[id*T + j], x3[id*T + j], x4[id*T + j], x5[id*T + j],
+            x6[id*T + j], err[id*T + j]);
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::stage2(t, h, s, p, n, pax, x0, x2, x3, x4, x5, x6, err);
+  }
+
+  static void stage3(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x3, T2* x4,
+      T2* x5, T2* x6, T2* err) {
+    coord_type cox;
+    int id = start, j;
+
+    while (id < end) {
+      for (j = 0; j < n; ++j) {
+        stage::stage3(t[j], h[j], s, p + j, cox, pax, x0[id*T + j],
+            x3[id*T + j], x4[id*T + j], x5[id*T + j], x6[id*T + j],
+            err[id*T + j]);
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::stage3(t, h, s, p, n, pax, x0, x3, x4, x5, x6, err);
+  }
+
+  static void stage4(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x4, T2* x5,
+      T2* x6, T2* err) {
+    coord_type cox;
+    int id = start, j;
+
+    while (id < end) {
+      for (j = 0; j < n; ++j) {
+        stage::stage4(t[j], h[j], s, p + j, cox, pax, x0[id*T + j],
+            x4[id*T + j], x5[id*T + j], x6[id*T + j], err[id*T + j]);
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::stage4(t, h, s, p, n, pax, x0, x4, x5, x6, err);
+  }
+
+  static void stage5(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x5, T2* x6,
+      T2* err) {
+    coord_type cox;
+    int id = start, j;
+
+    while (id < end) {
+      for (j = 0; j < n; ++j) {
+        stage::stage5(t[j], h[j], s, p + j, cox, pax, x0[id*T + j],
+            x5[id*T + j], x6[id*T + j], err[id*T + j]);
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::stage5(t, h, s, p, n, pax, x0, x5, x6, err);
+  }
+
+  static void stage6(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x6,
+      T2* err) {
+    coord_type cox;
+    int id = start, j;
+
+    while (id < end) {
+      for (j = 0; j < n; ++j) {
+        stage::stage6(t[j], h[j], s, p + j, cox, pax, x0[id*T + j],
+            x6[id*T + j], err[id*T + j]);
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::stage6(t, h, s, p, n, pax, x0, x6, err);
+  }
+
+  static void stageErr(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, const T2* x1,
+      T2* k7, T2* err) {
+    coord_type cox;
+    int id = start, j;
+
+    while (id < end) {
+      for (j = 0; j < n; ++j) {
+        stage::stageErr(t[j], h[j], s, p + j, cox, pax, x0[id*T + j],
+            x1[id*T + j], k7[id*T + j], err[id*T + j]);
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::stageErr(t, h, s, p, n, pax, x0, x1, k7, err);
+  }
+
+private:
+  typedef typename front<S2>::type front;
+  typedef typename pop_front<S2>::type pop_front;
+  typedef typename front::coord_type coord_type;
+  typedef typename front::target_type target_type;
+
+  typedef DOPRI5Stage<front,T1,B,ON_HOST,coord_type,PX,T2> stage;
+  typedef DOPRI5TileVisitorHost<B,S1,pop_front,T1,PX,T2,T> visitor;
+
+  static const int start = action_start<S1,front>::value;
+  static const int end = action_end<S1,front>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of DOPRI5TileVisitorHost.
+ */
+template<class B, class S1, class T1, class PX, class T2, int T>
+class DOPRI5TileVisitorHost<B,S1,empty_typelist,T1,PX,T2,T> {
+public:
+  static void map(int* ids) {
+    //
+  }
+
+  static void stage1(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x1, T2* x2,
+      T2* x3, T2* x4, T2* x5, T2* x6, T2* k1, T2* err,
+      const bool k1in = false) {
+    //
+  }
+
+  static void stage2(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x2, T2* x3,
+      T2* x4, T2* x5, T2* x6, T2* err) {
+    //
+  }
+
+  static void stage3(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x3, T2* x4,
+      T2* x5, T2* x6, T2* err) {
+    //
+  }
+
+  static void stage4(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x4, T2* x5,
+      T2* x6, T2* err) {
+    //
+  }
+
+  static void stage5(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x5, T2* x6,
+      T2* err) {
+    //
+  }
+
+  static void stage6(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, T2* x6,
+      T2* err) {
+    //
+  }
+
+  static void stageErr(const T1* t, const T1* h, const State<B,ON_HOST>& s,
+      const int p, const int n, const PX& pax, const T2* x0, const T2* x1,
+      T2* k7, T2* err) {
+    //
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_JACOBIANHOST_HPP
+#define BI_HOST_ODE_JACOBIANHOST_HPP
+
+#include "PaTileHost.hpp"
+#include "../../traits/var_traits.hpp"
+#include "../../traits/block_traits.hpp"
+
+namespace bi {
+/**
+ * Accumulator for the Jacobian of an ODE block, on host.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list of block.
+ *
+ * Receives partial derivatives from the @c jacobian functions of the
+ * actions of the block, and accumulates them into a dense matrix in
+ * row-major order, with one row and one column for each component of the
+ * block. Partial derivatives with respect to variables not updated by the
+ * block are discarded.
+ */
+template<class B, class S>
+struct JacobianHost {
+  /**
+   * Constructor.
+   *
+   * @param ids Map from each index of the d-net to the component of the
+   * block that updates it, or -1 if none.
+   * @param J Matrix.
+   */
+  JacobianHost(const int* ids, real* J);
+
+  /**
+   * Accumulate partial derivative for the current row.
+   *
+   * @tparam X Variable type.
+   *
+   * @param ix Serial index of variable.
+   * @param val Partial derivative with respect to variable.
+   */
+  template<class X>
+  void set(const int ix, const real val);
+
+  /**
+   * Map from d-net to block components.
+   */
+  const int* ids;
+
+  /**
+   * Matrix.
+   */
+  real* J;
+
+  /**
+   * Current row.
+   */
+  int row;
+};
+}
+
+template<class B, class S>
+inline bi::JacobianHost<B,S>::JacobianHost(const int* ids, real* J) :
+    ids(ids), J(J), row(0) {
+  //
+}
+
+template<class B, class S>
+template<class X>
+inline void bi::JacobianHost<B,S>::set(const int ix, const real val) {
+  static const int N = block_size<S>::value;
+  static const int start = tile_var_start<S,X>::value;
+
+  int col = -1;
+  if (start >= 0) {
+    col = start + ix;
+  } else if (is_d_var<X>::value && tile_has_var<S,X>::value) {
+    col = ids[var_start<X>::value + ix];
+  }
+  if (col >= 0) {
+    J[row*N + col] += val;
+  }
+}
+
+#endif
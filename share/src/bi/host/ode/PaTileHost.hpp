@@ -0,0 +1,191 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_PATILEHOST_HPP
+#define BI_HOST_ODE_PATILEHOST_HPP
+
+#include "../host.hpp"
+#include "../../state/State.hpp"
+#include "../../traits/var_traits.hpp"
+#include "../../traits/action_traits.hpp"
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+#include "../../typelist/equals.hpp"
+
+namespace bi {
+/**
+ * Parents of an action, with the variables of an ODE block read from a tile
+ * of stage buffers rather than from the state.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list of block.
+ * @tparam PX Parents type for all other variables.
+ * @tparam T Number of trajectories in tile.
+ *
+ * The tile stores the variables of the block in structure-of-arrays layout:
+ * component @c id of the block for trajectory <tt>p0 + j</tt> is at
+ * <tt>x[id*T + j]</tt>.
+ */
+template<class B, class S, class PX, int T>
+struct PaTileHost {
+  /**
+   * Constructor.
+   *
+   * @param ids Map from each index of the d-net to the component of the
+   * block that updates it, or -1 if none.
+   */
+  PaTileHost(const int* ids);
+
+  template<class X>
+  const host::vector_reference_type fetch(const State<B,ON_HOST>& s,
+      const int p) const;
+
+  template<class X>
+  const host::vector_reference_alt_type fetch_alt(
+      const State<B,ON_HOST>& s, const int p) const;
+
+  template<class X>
+  const real& fetch(const State<B,ON_HOST>& s, const int p,
+      const int ix) const;
+
+  template<class X>
+  const real& fetch_alt(const State<B,ON_HOST>& s, const int p,
+      const int ix) const;
+
+  /**
+   * Map from d-net to block components.
+   */
+  const int* ids;
+
+  /**
+   * Stage buffer from which to read.
+   */
+  const real* x;
+
+  /**
+   * Index of first trajectory in tile.
+   */
+  int p0;
+
+  /**
+   * Parents for all other variables.
+   */
+  PX pax;
+};
+
+/**
+ * @internal
+ *
+ * Is a variable updated by any action of a block?
+ *
+ * @tparam S Action type list.
+ * @tparam X Variable type.
+ */
+template<class S, class X>
+struct tile_has_var {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  static const bool value = equals<typename front::target_type,X>::value ||
+      tile_has_var<pop_front,X>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of tile_has_var.
+ */
+template<class X>
+struct tile_has_var<empty_typelist,X> {
+  static const bool value = false;
+};
+
+/**
+ * @internal
+ *
+ * Component of a block at which a variable starts, if the variable is
+ * updated in its entirety by a single action of the block, otherwise -1.
+ *
+ * @tparam S Action type list.
+ * @tparam X Variable type.
+ */
+template<class S, class X>
+struct tile_var_start {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  static const bool match = equals<typename front::target_type,X>::value &&
+      action_size<front>::value == var_size<X>::value;
+  static const int rest = tile_var_start<pop_front,X>::value;
+  static const int value = match ? 0 : ((rest < 0) ? -1 :
+      action_size<front>::value + rest);
+};
+
+/**
+ * @internal
+ *
+ * Base case of tile_var_start.
+ */
+template<class X>
+struct tile_var_start<empty_typelist,X> {
+  static const int value = -1;
+};
+
+}
+
+template<class B, class S, class PX, int T>
+inline bi::PaTileHost<B,S,PX,T>::PaTileHost(const int* ids) : ids(ids),
+    x(NULL), p0(0) {
+  //
+}
+
+template<class B, class S, class PX, int T>
+template<class X>
+inline const bi::host::vector_reference_type
+bi::PaTileHost<B,S,PX,T>::fetch(const State<B,ON_HOST>& s,
+    const int p) const {
+  /* whole vectors are only fetched by matrix actions, never in ODE blocks */
+  return pax.template fetch<X>(s, p);
+}
+
+template<class B, class S, class PX, int T>
+template<class X>
+inline const bi::host::vector_reference_alt_type
+bi::PaTileHost<B,S,PX,T>::fetch_alt(const State<B,ON_HOST>& s,
+    const int p) const {
+  return pax.template fetch_alt<X>(s, p);
+}
+
+template<class B, class S, class PX, int T>
+template<class X>
+inline const real& bi::PaTileHost<B,S,PX,T>::fetch(
+    const State<B,ON_HOST>& s, const int p, const int ix) const {
+  static const int start = tile_var_start<S,X>::value;
+
+  if (start >= 0) {
+    /* position in tile known at compile time, the usual case */
+    return x[(start + ix)*T + p - p0];
+  } else if (is_d_var<X>::value && tile_has_var<S,X>::value) {
+    /* variable updated piecewise by several actions */
+    const int id = ids[var_start<X>::value + ix];
+    if (id >= 0) {
+      return x[id*T + p - p0];
+    }
+  }
+  return pax.template fetch<X>(s, p, ix);
+}
+
+template<class B, class S, class PX, int T>
+template<class X>
+inline const real& bi::PaTileHost<B,S,PX,T>::fetch_alt(
+    const State<B,ON_HOST>& s, const int p, const int ix) const {
+  return pax.template fetch_alt<X>(s, p, ix);
+}
+
+#endif
@@ -8,6 +8,8 @@
 #ifndef BI_HOST_ODE_RK43INTEGRATORHOST_HPP
 #define BI_HOST_ODE_RK43INTEGRATORHOST_HPP
 
+#include "../../ode/IntegratorConfig.hpp"
+
 namespace bi {
 /**
  * RK4(3)5[2R+]C low-storage Runge-Kutta integrator.
@@ -28,16 +30,17 @@ public:
   /**
    * Integrate.
    *
+   * @param cfg Integrator configuration.
    * @param t1 Start of time interval.
    * @param t2 End of time interval.
    * @param[in,out] s State.
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
 #include "RK43VisitorHost.hpp"
-#include "IntegratorConstants.hpp"
 #include "../host.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
@@ -47,8 +50,8 @@ public:
 #include "../../math/temp_vector.hpp"
 
 template<class B, class S, class T1>
-void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+void bi::RK43IntegratorHost<B,S,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
@@ -74,15 +77,15 @@ void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
     #pragma omp for
     for (p = 0; p < P; ++p) {
       t = t1;
-      h = h_h0;
+      h = cfg.h0;
       logfacold = bi::log(BI_REAL(1.0e-4));
       n = 0;
       host_load<B,S>(s, p, old);
       r1 = old;
 
       /* integrate */
-      while (t < t2 && n < h_nsteps) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+      while (t < t2 && n < cfg.nsteps) {
+        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*cfg.uround) {
           // step size too small
         }
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
@@ -112,7 +115,7 @@ void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
         /* compute error */
         e2 = BI_REAL(0.0);
         for (id = 0; id < N; ++id) {
-          e = err(id)*h/(h_atoler + h_rtoler*bi::max(bi::abs(old(id)), bi::abs(r1(id))));
+          e = err(id)*h/(cfg.atoler + cfg.rtoler*bi::max(bi::abs(old(id)), bi::abs(r1(id))));
           e2 += e*e;
         }
         e2 /= N;
@@ -131,14 +134,14 @@ void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
 
         /* compute next step size */
         if (t < t2) {
-          logfac11 = h_expo*bi::log(e2);
+          logfac11 = cfg.expo*bi::log(e2);
           if (e2 > BI_REAL(1.0)) {
             /* step was rejected */
-            h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
+            h *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11));
           } else {
             /* step was accepted */
-            fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11); // Lund-stabilization
-            fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
+            fac = bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11); // Lund-stabilization
+            fac = bi::min(cfg.facr, bi::max(cfg.facl, fac)); // bound
             h *= fac;
             logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
           }
@@ -8,6 +8,8 @@
 #ifndef BI_HOST_ODE_RK4INTEGRATORHOST_HPP
 #define BI_HOST_ODE_RK4INTEGRATORHOST_HPP
 
+#include "../../ode/IntegratorConfig.hpp"
+
 namespace bi {
 /**
  * Classic fourth order Runge-Kutta integrator.
@@ -24,16 +26,17 @@ public:
   /**
    * Integrate.
    *
+   * @param cfg Integrator configuration.
    * @param t1 Start of time interval.
    * @param t2 End of time interval.
    * @param[in,out] s State.
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
 #include "RK4VisitorHost.hpp"
-#include "IntegratorConstants.hpp"
 #include "../host.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
@@ -42,8 +45,8 @@ public:
 #include "../../math/view.hpp"
 
 template<class B, class S, class T1>
-void bi::RK4IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+void bi::RK4IntegratorHost<B,S,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
@@ -70,13 +73,13 @@ void bi::RK4IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
     #pragma omp for
     for (p = 0; p < P; ++p) {
       t = t1;
-      h = h_h0;
+      h = cfg.h0;
       host_load<B,S>(s, p, x0);
 
       /* integrate */
       while (t < t2) {
         /* initialise */
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*cfg.uround) {
           // step size too small
         }
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
@@ -0,0 +1,277 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_ROS23INTEGRATORHOST_HPP
+#define BI_HOST_ODE_ROS23INTEGRATORHOST_HPP
+
+#include "../../ode/IntegratorConfig.hpp"
+
+namespace bi {
+/**
+ * Rosenbrock 2(3) integrator for stiff systems.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ * @tparam T1 Scalar type.
+ *
+ * Implements the L-stable, linearly implicit method of
+ * @ref Shampine1997 "Shampine & Reichelt (1997)", with error estimate of
+ * order three. Each step requires one evaluation of the Jacobian, which is
+ * generated from the symbolic form of the differential equations, one LU
+ * decomposition of a dense matrix, and two evaluations of the time
+ * derivatives, the third being reused for the next step. As differential
+ * equations have no explicit dependence on time, the time derivative term of
+ * the method is zero.
+ *
+ * @section ROS23IntegratorHost_references References
+ *
+ * @anchor Shampine1997 Shampine, L. F. and Reichelt, M. W. The MATLAB ODE
+ * Suite. <i>SIAM Journal on Scientific Computing</i>, <b>1997</b>, 18, 1-22.
+ */
+template<class B, class S, class T1>
+class ROS23IntegratorHost {
+public:
+  /**
+   * Integrate.
+   *
+   * @param cfg Integrator configuration.
+   * @param t1 Start of time interval.
+   * @param t2 End of time interval.
+   * @param[in,out] s State.
+   */
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * LU decomposition with partial pivoting, in place.
+   *
+   * @param[in,out] W Row-major matrix.
+   * @param[out] piv Pivots.
+   */
+  static void factor(real* W, int* piv);
+
+  /**
+   * Solve linear system, in place, given LU decomposition.
+   *
+   * @param W LU decomposition, as from factor().
+   * @param piv Pivots, as from factor().
+   * @param[in,out] x Right hand side on input, solution on output.
+   */
+  static void solve(const real* W, const int* piv, real* x);
+};
+}
+
+#include "ROS23VisitorHost.hpp"
+#include "JacobianHost.hpp"
+#include "../host.hpp"
+#include "../../state/Pa.hpp"
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+#include "../../traits/block_traits.hpp"
+
+#include <vector>
+#include <algorithm>
+
+template<class B, class S, class T1>
+void bi::ROS23IntegratorHost<B,S,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  typedef host_vector_reference<real> vector_reference_type;
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef ROS23VisitorHost<B,S,S,real,PX,real> Visitor;
+  typedef JacobianHost<B,S> jacobian_type;
+
+  static const int N = block_size<S>::value;
+  const int P = s.size();
+
+  /* method coefficients */
+  const real d = BI_REAL(1.0)/(BI_REAL(2.0) + bi::sqrt(BI_REAL(2.0)));
+  const real e32 = BI_REAL(6.0) + bi::sqrt(BI_REAL(2.0));
+
+  /* map from d-net to components of block, for Jacobian */
+  std::vector<int> ids(B::ND + 1, -1);
+  Visitor::map(&ids[0]);
+
+  #pragma omp parallel
+  {
+    /* heap allocation, as Jacobian may be large */
+    std::vector<real> buf(8*N + 2*N*N);
+    std::vector<int> piv(N);
+    vector_reference_type x0(&buf[0], N);
+    vector_reference_type x1(&buf[N], N);
+    real *f0 = &buf[2*N], *f1 = &buf[3*N], *f2 = &buf[4*N];
+    real *k1 = &buf[5*N], *k2 = &buf[6*N], *k3 = &buf[7*N];
+    real *J = &buf[8*N], *W = &buf[8*N + N*N];
+    jacobian_type jac(&ids[0], J);
+
+    real t, h, e, e2, logfacold, logfac, fac;
+    int n, id, p;
+    PX pax;
+
+    #pragma omp for
+    for (p = 0; p < P; ++p) {
+      t = t1;
+      h = cfg.h0;
+      logfacold = bi::log(BI_REAL(1.0e-4));
+      n = 0;
+      host_load<B,S>(s, p, x0);
+      Visitor::dfdt(t, s, p, pax, f0);
+      std::fill(J, J + N*N, BI_REAL(0.0));
+      Visitor::jacobian(t, s, p, pax, jac);
+
+      /* integrate */
+      while (t < t2 && n < cfg.nsteps) {
+        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*cfg.uround) {
+          // step size too small
+        }
+        if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
+          h = t2 - t;
+          if (h <= BI_REAL(0.0)) {
+            t = t2;
+            break;
+          }
+        }
+
+        /* W = I - h*d*J */
+        for (id = 0; id < N*N; ++id) {
+          W[id] = -h*d*J[id];
+        }
+        for (id = 0; id < N; ++id) {
+          W[id*N + id] += BI_REAL(1.0);
+        }
+        factor(W, &piv[0]);
+
+        /* stage 1 */
+        std::copy(f0, f0 + N, k1);
+        solve(W, &piv[0], k1);
+
+        /* stage 2 */
+        for (id = 0; id < N; ++id) {
+          x1(id) = x0(id) + BI_REAL(0.5)*h*k1[id];
+        }
+        host_store<B,S>(s, p, x1);
+        Visitor::dfdt(t + BI_REAL(0.5)*h, s, p, pax, f1);
+        for (id = 0; id < N; ++id) {
+          k2[id] = f1[id] - k1[id];
+        }
+        solve(W, &piv[0], k2);
+        for (id = 0; id < N; ++id) {
+          k2[id] += k1[id];
+          x1(id) = x0(id) + h*k2[id];
+        }
+
+        /* stage 3, for error estimate */
+        host_store<B,S>(s, p, x1);
+        Visitor::dfdt(t + h, s, p, pax, f2);
+        for (id = 0; id < N; ++id) {
+          k3[id] = f2[id] - e32*(k2[id] - f1[id]) - BI_REAL(2.0)*(k1[id] - f0[id]);
+        }
+        solve(W, &piv[0], k3);
+
+        /* compute error */
+        e2 = BI_REAL(0.0);
+        for (id = 0; id < N; ++id) {
+          e = h/BI_REAL(6.0)*(k1[id] - BI_REAL(2.0)*k2[id] + k3[id])/
+              (cfg.atoler + cfg.rtoler*bi::max(bi::abs(x0(id)), bi::abs(x1(id))));
+          e2 += e*e;
+        }
+        e2 /= N;
+
+        if (e2 <= BI_REAL(1.0)) {
+          /* accept, state already holds new values */
+          t += h;
+          if (t < t2) {
+            x0 = x1;
+            std::copy(f2, f2 + N, f0);
+            std::fill(J, J + N*N, BI_REAL(0.0));
+            Visitor::jacobian(t, s, p, pax, jac);
+          }
+        } else {
+          /* reject */
+          host_store<B,S>(s, p, x0);
+        }
+
+        /* compute next step size, error estimate is of order three */
+        if (t < t2) {
+          logfac = bi::log(e2)/BI_REAL(6.0);
+          if (e2 > BI_REAL(1.0)) {
+            /* step was rejected */
+            h *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac));
+          } else {
+            /* step was accepted */
+            fac = bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac); // Lund-stabilization
+            fac = bi::min(cfg.facr, bi::max(cfg.facl, fac)); // bound
+            h *= fac;
+            logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
+          }
+        }
+
+        ++n;
+      }
+    }
+  }
+}
+
+template<class B, class S, class T1>
+void bi::ROS23IntegratorHost<B,S,T1>::factor(real* W, int* piv) {
+  static const int N = block_size<S>::value;
+  int i, j, k, m;
+  real a;
+
+  for (k = 0; k < N; ++k) {
+    /* pivot */
+    m = k;
+    for (i = k + 1; i < N; ++i) {
+      if (bi::abs(W[i*N + k]) > bi::abs(W[m*N + k])) {
+        m = i;
+      }
+    }
+    piv[k] = m;
+    if (m != k) {
+      std::swap_ranges(W + k*N, W + (k + 1)*N, W + m*N);
+    }
+
+    /* eliminate */
+    for (i = k + 1; i < N; ++i) {
+      a = W[i*N + k]/W[k*N + k];
+      W[i*N + k] = a;
+      for (j = k + 1; j < N; ++j) {
+        W[i*N + j] -= a*W[k*N + j];
+      }
+    }
+  }
+}
+
+template<class B, class S, class T1>
+void bi::ROS23IntegratorHost<B,S,T1>::solve(const real* W, const int* piv,
+    real* x) {
+  static const int N = block_size<S>::value;
+  int i, j;
+
+  /* forward substitution */
+  for (i = 0; i < N; ++i) {
+    std::swap(x[i], x[piv[i]]);
+    for (j = 0; j < i; ++j) {
+      x[i] -= W[i*N + j]*x[j];
+    }
+  }
+
+  /* back substitution */
+  for (i = N - 1; i >= 0; --i) {
+    for (j = i + 1; j < N; ++j) {
+      x[i] -= W[i*N + j]*x[j];
+    }
+    x[i] /= W[i*N + i];
+  }
+}
+
+#endif
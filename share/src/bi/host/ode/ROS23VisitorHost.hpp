@@ -0,0 +1,117 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_ROS23VISITORHOST_HPP
+#define BI_HOST_ODE_ROS23VISITORHOST_HPP
+
+namespace bi {
+/**
+ * Visitor for ROS23IntegratorHost.
+ *
+ * @tparam B Model type.
+ * @tparam S1 Action type list.
+ * @tparam S2 Action type list.
+ * @tparam T1 Scalar type.
+ * @tparam PX Parents type.
+ * @tparam T2 Scalar type.
+ */
+template<class B, class S1, class S2, class T1, class PX, class T2>
+class ROS23VisitorHost {
+public:
+  /**
+   * Map each index of the d-net to the component of the block that updates
+   * it.
+   *
+   * @param[out] ids Map, entries not updated by the block are untouched.
+   */
+  static void map(int* ids) {
+    coord_type cox;
+    int id = start;
+
+    while (id < end) {
+      if (is_d_var<target_type>::value) {
+        ids[var_start<target_type>::value + cox.index()] = id;
+      }
+      ++cox;
+      ++id;
+    }
+    visitor::map(ids);
+  }
+
+  /**
+   * Evaluate time derivatives of all components.
+   */
+  static void dfdt(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* f) {
+    coord_type cox;
+    int id = start;
+
+    while (id < end) {
+      front::dfdt(t, s, p, cox, pax, f[id]);
+      ++cox;
+      ++id;
+    }
+    visitor::dfdt(t, s, p, pax, f);
+  }
+
+  /**
+   * Evaluate Jacobian of time derivatives, one row per component.
+   */
+  template<class J1>
+  static void jacobian(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, J1& jac) {
+    coord_type cox;
+    int id = start;
+
+    while (id < end) {
+      jac.row = id;
+      front::jacobian(t, s, p, cox, pax, jac);
+      ++cox;
+      ++id;
+    }
+    visitor::jacobian(t, s, p, pax, jac);
+  }
+
+private:
+  typedef typename front<S2>::type front;
+  typedef typename pop_front<S2>::type pop_front;
+  typedef typename front::coord_type coord_type;
+  typedef typename front::target_type target_type;
+
+  typedef ROS23VisitorHost<B,S1,pop_front,T1,PX,T2> visitor;
+
+  static const int start = action_start<S1,front>::value;
+  static const int end = action_end<S1,front>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of ROS23VisitorHost.
+ */
+template<class B, class S1, class T1, class PX, class T2>
+class ROS23VisitorHost<B,S1,empty_typelist,T1,PX,T2> {
+public:
+  static void map(int* ids) {
+    //
+  }
+
+  static void dfdt(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* f) {
+    //
+  }
+
+  template<class J1>
+  static void jacobian(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, J1& jac) {
+    //
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_RANDOM_PHILOX_HPP
+#define BI_HOST_RANDOM_PHILOX_HPP
+
+#include "boost/cstdint.hpp"
+
+namespace bi {
+/**
+ * Counter-based pseudorandom number generator, on host.
+ *
+ * @ingroup math_rng
+ *
+ * Implements the Philox4x32-10 bijection of
+ * @ref Salmon2011 "Salmon et al. (2011)", wrapped as an engine compatible
+ * with the distributions of Boost.Random. Each application of the bijection
+ * maps a 128-bit counter and 64-bit key to four 32-bit variates. The state
+ * of the engine is just the key, the counter, and a buffer of the last four
+ * variates, so that copies are cheap and any variate may be computed
+ * directly from its position in the sequence.
+ *
+ * The two high words of the counter select a stream, set with stream(). The
+ * two low words count blocks of four variates within that stream.
+ *
+ * @section Philox_references References
+ *
+ * @anchor Salmon2011 Salmon, J. K.; Moraes, M. A.; Dror, R. O. and Shaw,
+ * D. E. Parallel random numbers: As easy as 1, 2, 3. <i>Proceedings of
+ * 2011 International Conference for High Performance Computing, Networking,
+ * Storage and Analysis</i>, <b>2011</b>.
+ */
+class Philox4x32 {
+public:
+  /**
+   * Result type.
+   */
+  typedef boost::uint32_t result_type;
+
+  /**
+   * Constructor.
+   *
+   * @param k0 First word of key.
+   * @param k1 Second word of key.
+   */
+  Philox4x32(const boost::uint32_t k0 = 0, const boost::uint32_t k1 = 0);
+
+  /**
+   * Seed, setting the key and returning to the start of stream zero.
+   *
+   * @param k0 First word of key.
+   * @param k1 Second word of key.
+   */
+  void seed(const boost::uint32_t k0 = 0, const boost::uint32_t k1 = 0);
+
+  /**
+   * Select stream, returning to its start.
+   *
+   * @param c2 Third word of counter.
+   * @param c3 Fourth word of counter.
+   */
+  void stream(const boost::uint32_t c2, const boost::uint32_t c3);
+
+  /**
+   * Next variate.
+   */
+  result_type operator()();
+
+  /**
+   * Minimum variate.
+   */
+  static result_type min();
+
+  /**
+   * Maximum variate.
+   */
+  static result_type max();
+
+  /**
+   * Compute block of variates of a stream directly, without changing the
+   * state of the engine.
+   *
+   * @param b Index of block within stream.
+   * @param c2 Third word of counter.
+   * @param c3 Fourth word of counter.
+   * @param[out] out Variates.
+   *
+   * Block @p b of stream (@p c2, @p c3) gives the variates numbered
+   * <tt>4*b</tt> to <tt>4*b + 3</tt> of that stream.
+   */
+  void block(const boost::uint32_t b, const boost::uint32_t c2,
+      const boost::uint32_t c3, boost::uint32_t out[4]) const;
+
+  /**
+   * Convert variate to uniform on the open interval (0,1).
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param x Variate.
+   */
+  template<class T1>
+  static T1 toUniform(const result_type x);
+
+  /**
+   * Apply Philox4x32-10 bijection.
+   *
+   * @param ctr Counter.
+   * @param key Key.
+   * @param[out] out Variates.
+   */
+  static void block(const boost::uint32_t ctr[4], const boost::uint32_t key[2],
+      boost::uint32_t out[4]);
+
+private:
+  /**
+   * Key.
+   */
+  boost::uint32_t key[2];
+
+  /**
+   * Counter for next block.
+   */
+  boost::uint32_t ctr[4];
+
+  /**
+   * Current block.
+   */
+  boost::uint32_t out[4];
+
+  /**
+   * Index of next variate in current block.
+   */
+  int i;
+};
+}
+
+inline bi::Philox4x32::Philox4x32(const boost::uint32_t k0,
+    const boost::uint32_t k1) {
+  seed(k0, k1);
+}
+
+inline void bi::Philox4x32::seed(const boost::uint32_t k0,
+    const boost::uint32_t k1) {
+  key[0] = k0;
+  key[1] = k1;
+  stream(0, 0);
+}
+
+inline void bi::Philox4x32::stream(const boost::uint32_t c2,
+    const boost::uint32_t c3) {
+  ctr[0] = 0;
+  ctr[1] = 0;
+  ctr[2] = c2;
+  ctr[3] = c3;
+  i = 4;
+}
+
+inline bi::Philox4x32::result_type bi::Philox4x32::operator()() {
+  if (i == 4) {
+    block(ctr, key, out);
+    if (++ctr[0] == 0) {
+      ++ctr[1];
+    }
+    i = 0;
+  }
+  return out[i++];
+}
+
+inline bi::Philox4x32::result_type bi::Philox4x32::min() {
+  return 0;
+}
+
+inline bi::Philox4x32::result_type bi::Philox4x32::max() {
+  return 0xFFFFFFFFu;
+}
+
+inline void bi::Philox4x32::block(const boost::uint32_t b,
+    const boost::uint32_t c2, const boost::uint32_t c3,
+    boost::uint32_t out[4]) const {
+  const boost::uint32_t ctr1[4] = { b, 0, c2, c3 };
+  block(ctr1, key, out);
+}
+
+template<class T1>
+inline T1 bi::Philox4x32::toUniform(const result_type x) {
+  /* 32 bits, exact in double precision */
+  return (static_cast<T1>(x) + static_cast<T1>(0.5))*
+      static_cast<T1>(2.3283064365386963e-10);
+}
+
+namespace bi {
+template<>
+inline float Philox4x32::toUniform<float>(const result_type x) {
+  /* 23 bits, so that adding one half remains exact in single precision */
+  return (static_cast<float>(x >> 9) + 0.5f)*1.1920928955078125e-7f;
+}
+}
+
+inline void bi::Philox4x32::block(const boost::uint32_t ctr[4],
+    const boost::uint32_t key[2], boost::uint32_t out[4]) {
+  static const boost::uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  static const boost::uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+  boost::uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+  boost::uint32_t k0 = key[0], k1 = key[1];
+  boost::uint64_t p0, p1;
+
+  for (int r = 0; r < 10; ++r) {
+    p0 = static_cast<boost::uint64_t>(M0)*c0;
+    p1 = static_cast<boost::uint64_t>(M1)*c2;
+    c0 = static_cast<boost::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    c2 = static_cast<boost::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c1 = static_cast<boost::uint32_t>(p1);
+    c3 = static_cast<boost::uint32_t>(p0);
+    k0 += W0;
+    k1 += W1;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+#endif
@@ -14,6 +14,18 @@
 void bi::RandomHost::seeds(Random& rng, const unsigned seed) {
   #pragma omp parallel
   {
+    #ifdef ENABLE_PHILOX
+    /* all threads share the same key, streams distinguish them */
+    #ifdef ENABLE_MPI
+    boost::mpi::communicator world;
+    const int rank = world.rank();
+    const int size = world.size();
+
+    int s = seed*size + rank;
+    #else
+    int s = seed;
+    #endif
+    #else
     #ifdef ENABLE_MPI
     boost::mpi::communicator world;
     const int rank = world.rank();
@@ -23,7 +35,8 @@ void bi::RandomHost::seeds(Random& rng, const unsigned seed) {
     #else
     int s = seed*bi_omp_max_threads + bi_omp_tid;
     #endif
+    #endif
 
-    rng.getHostRng().seed(s);
+    rng.getHostRng().seed(s, bi_omp_tid);
   }
 }
@@ -12,11 +12,30 @@
 #include "../../misc/location.hpp"
 #include "../../cuda/cuda.hpp"
 
+/**
+ * @def BI_RANDOM_BLOCK_SIZE
+ *
+ * Number of variates drawn at a time by the batched generators of
+ * RandomHost. Must be a multiple of 32, so that a block splits into two
+ * halves of whole sse_real vectors at any width and precision.
+ */
+#ifndef BI_RANDOM_BLOCK_SIZE
+#define BI_RANDOM_BLOCK_SIZE 256
+#endif
+
 namespace bi {
 class Random;
+class RngHost;
 
 /**
  * Implementation of Random on host.
+ *
+ * uniforms(), gaussians() and gammas() fill their output in blocks of
+ * #BI_RANDOM_BLOCK_SIZE variates, distributed across threads. Within each
+ * block, raw variates are first drawn into a buffer, then transformed in
+ * bulk, so that the transformation vectorises. When compiled with
+ * @c ENABLE_PHILOX, each block has its own stream, so that results do not
+ * depend on the number of threads.
  */
 struct RandomHost {
   /**
@@ -58,10 +77,83 @@ struct RandomHost {
    */
   template<class V1, class V2>
   static void multinomials(Random& rng, const V1 lps, V2 xs);
+
+  /**
+   * Draw block of uniform variates on (0,1).
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param rng Random number generator.
+   * @param[out] u Variates.
+   * @param n Number of variates.
+   */
+  template<class T1>
+  static void uniformBlock(RngHost& rng, T1* u, const int n);
+
+  /**
+   * Draw block of standard Gaussian variates.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param rng Random number generator.
+   * @param[out] z Variates.
+   * @param n Number of variates.
+   *
+   * @p n is rounded up to a multiple of 32, and that many variates written
+   * to @p z, which must be aligned to #BI_SSE_ALIGN bytes.
+   */
+  template<class T1>
+  static void gaussianBlock(RngHost& rng, T1* z, const int n);
+
+  /**
+   * Draw block of standard gamma variates.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param rng Random number generator.
+   * @param alpha Shape.
+   * @param[out] g Variates.
+   * @param n Number of variates, no more than #BI_RANDOM_BLOCK_SIZE.
+   *
+   * Uses the method of @ref Marsaglia2000 "Marsaglia & Tsang (2000)",
+   * drawing candidates for all outstanding variates at once and repeating
+   * for those rejected.
+   *
+   * @section RandomHost_references References
+   *
+   * @anchor Marsaglia2000 Marsaglia, G. and Tsang, W. W. A simple method
+   * for generating gamma variables. <i>ACM Transactions on Mathematical
+   * Software</i>, <b>2000</b>, 26, 363-372.
+   */
+  template<class T1>
+  static void gammaBlock(RngHost& rng, const T1 alpha, T1* g, const int n);
+
+  /**
+   * Box-Muller transform of uniform to Gaussian variates.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param u Uniform variates on (0,1).
+   * @param[out] z Standard Gaussian variates.
+   * @param n Number of variates, a multiple of 32.
+   *
+   * Variates <tt>u[k]</tt> and <tt>u[n/2 + k]</tt> give <tt>z[k]</tt> and
+   * <tt>z[n/2 + k]</tt>. @p u and @p z may be the same.
+   */
+  template<class T1>
+  static void boxMuller(const T1* u, T1* z, const int n);
 };
 }
 
+#include "Philox.hpp"
 #include "../../random/Random.hpp"
+#include "../../math/function.hpp"
+#include "../../math/pi.hpp"
+#include "../../misc/compile.hpp"
+
+#ifdef ENABLE_SSE
+#include "../../sse/random/RandomSSE.hpp"
+#endif
 
 template<class V1>
 void bi::RandomHost::uniforms(Random& rng, V1 x,
@@ -71,20 +163,30 @@ void bi::RandomHost::uniforms(Random& rng, V1 x,
   BI_ASSERT(upper >= lower);
 
   typedef typename V1::value_type T1;
-  typedef boost::uniform_real<T1> dist_type;
+
+  const unsigned t = rng.step();
+  const int n = x.size();
+  const int nblocks = (n + BI_RANDOM_BLOCK_SIZE - 1)/BI_RANDOM_BLOCK_SIZE;
+  const T1 range = upper - lower;
 
   #pragma omp parallel
   {
     RngHost& rng1 = rng.getHostRng();
-    int j;
-
-    dist_type dist(lower, upper);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
+    CUDA_ALIGN(BI_SSE_ALIGN) T1 u[BI_RANDOM_BLOCK_SIZE] BI_ALIGN(BI_SSE_ALIGN);
+    int b, j, k, m;
 
-    #pragma omp for
-    for (j = 0; j < x.size(); ++j) {
-      x(j) = gen();
+    #pragma omp for schedule(static)
+    for (b = 0; b < nblocks; ++b) {
+      j = b*BI_RANDOM_BLOCK_SIZE;
+      m = bi::min(BI_RANDOM_BLOCK_SIZE, n - j);
+
+      rng1.beginStream(b, t);
+      uniformBlock(rng1, u, m);
+      for (k = 0; k < m; ++k) {
+        x(j + k) = lower + range*u[k];
+      }
     }
+    rng1.endStream();
   }
 }
 
@@ -95,20 +197,29 @@ void bi::RandomHost::gaussians(Random& rng, V1 x,
   BI_ASSERT(sigma >= 0.0);
 
   typedef typename V1::value_type T1;
-  typedef boost::normal_distribution<T1> dist_type;
+
+  const unsigned t = rng.step();
+  const int n = x.size();
+  const int nblocks = (n + BI_RANDOM_BLOCK_SIZE - 1)/BI_RANDOM_BLOCK_SIZE;
 
   #pragma omp parallel
   {
     RngHost& rng1 = rng.getHostRng();
-    int j;
-
-    dist_type dist(mu, sigma);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
+    CUDA_ALIGN(BI_SSE_ALIGN) T1 z[BI_RANDOM_BLOCK_SIZE] BI_ALIGN(BI_SSE_ALIGN);
+    int b, j, k, m;
 
     #pragma omp for schedule(static)
-    for (j = 0; j < x.size(); ++j) {
-      x(j) = gen();
+    for (b = 0; b < nblocks; ++b) {
+      j = b*BI_RANDOM_BLOCK_SIZE;
+      m = bi::min(BI_RANDOM_BLOCK_SIZE, n - j);
+
+      rng1.beginStream(b, t);
+      gaussianBlock(rng1, z, m);
+      for (k = 0; k < m; ++k) {
+        x(j + k) = mu + sigma*z[k];
+      }
     }
+    rng1.endStream();
   }
 }
 
@@ -119,20 +230,29 @@ void bi::RandomHost::gammas(Random& rng, V1 x,
   BI_ASSERT(alpha > 0.0 && beta > 0.0);
 
   typedef typename V1::value_type T1;
-  typedef boost::gamma_distribution<T1> dist_type;
+
+  const unsigned t = rng.step();
+  const int n = x.size();
+  const int nblocks = (n + BI_RANDOM_BLOCK_SIZE - 1)/BI_RANDOM_BLOCK_SIZE;
 
   #pragma omp parallel
   {
     RngHost& rng1 = rng.getHostRng();
-    int j;
-
-    dist_type dist(alpha);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
+    CUDA_ALIGN(BI_SSE_ALIGN) T1 g[BI_RANDOM_BLOCK_SIZE] BI_ALIGN(BI_SSE_ALIGN);
+    int b, j, k, m;
 
     #pragma omp for schedule(static)
-    for (j = 0; j < x.size(); ++j) {
-      x(j) = beta*gen();
+    for (b = 0; b < nblocks; ++b) {
+      j = b*BI_RANDOM_BLOCK_SIZE;
+      m = bi::min(BI_RANDOM_BLOCK_SIZE, n - j);
+
+      rng1.beginStream(b, t);
+      gammaBlock(rng1, alpha, g, m);
+      for (k = 0; k < m; ++k) {
+        x(j + k) = beta*g[k];
+      }
     }
+    rng1.endStream();
   }
 }
 
@@ -145,6 +265,8 @@ void bi::RandomHost::betas(Random& rng, V1 x,
   typedef typename V1::value_type T1;
   typedef boost::gamma_distribution<T1> dist_type;
 
+  const unsigned t = rng.step();
+
   #pragma omp parallel
   {
     RngHost& rng1 = rng.getHostRng();
@@ -156,11 +278,13 @@ void bi::RandomHost::betas(Random& rng, V1 x,
 
     #pragma omp for schedule(static)
     for (j = 0; j < x.size(); ++j) {
+      rng1.beginStream(j, t);
       y1 = gen1();
       y2 = gen2();
 
       x(j) = y1/(y1 + y2);
     }
+    rng1.endStream();
   }
 }
 
@@ -189,4 +313,94 @@ void bi::RandomHost::multinomials(Random& rng, const V1 lps, V2 xs) {
   }
 }
 
+template<class T1>
+inline void bi::RandomHost::uniformBlock(RngHost& rng, T1* u,
+    const int n) {
+  int k;
+  for (k = 0; k < n; ++k) {
+    u[k] = Philox4x32::toUniform<T1>(rng.rng());
+  }
+}
+
+template<class T1>
+inline void bi::RandomHost::gaussianBlock(RngHost& rng, T1* z,
+    const int n) {
+  const int m = (n + 31)/32*32;
+
+  uniformBlock(rng, z, m);
+  boxMuller(z, z, m);
+}
+
+template<class T1>
+void bi::RandomHost::gammaBlock(RngHost& rng, const T1 alpha, T1* g,
+    const int n) {
+  /* pre-condition */
+  BI_ASSERT(n <= BI_RANDOM_BLOCK_SIZE);
+
+  /* for alpha < 1, draw with shape alpha + 1 and scale by u^(1/alpha) */
+  const T1 a = (alpha < static_cast<T1>(1.0)) ? alpha + static_cast<T1>(1.0) : alpha;
+  const T1 d = a - static_cast<T1>(1.0/3.0);
+  const T1 c = static_cast<T1>(1.0)/bi::sqrt(static_cast<T1>(9.0)*d);
+
+  CUDA_ALIGN(BI_SSE_ALIGN) T1 z[BI_RANDOM_BLOCK_SIZE] BI_ALIGN(BI_SSE_ALIGN);
+  CUDA_ALIGN(BI_SSE_ALIGN) T1 u[BI_RANDOM_BLOCK_SIZE] BI_ALIGN(BI_SSE_ALIGN);
+  T1 v;
+  int k, m, filled = 0;
+
+  while (filled < n) {
+    m = n - filled;
+    gaussianBlock(rng, z, m);
+    uniformBlock(rng, u, m);
+
+    /* candidates and acceptance margins */
+    for (k = 0; k < m; ++k) {
+      v = static_cast<T1>(1.0) + c*z[k];
+      v = v*v*v;
+      u[k] = (v > static_cast<T1>(0.0)) ?
+          static_cast<T1>(0.5)*z[k]*z[k] + d - d*v + d*bi::log(v) -
+          bi::log(u[k]) : static_cast<T1>(-1.0);
+      z[k] = d*v;
+    }
+
+    /* compact accepted candidates */
+    for (k = 0; k < m; ++k) {
+      if (u[k] > static_cast<T1>(0.0)) {
+        g[filled++] = z[k];
+      }
+    }
+  }
+
+  if (alpha < static_cast<T1>(1.0)) {
+    const T1 alphaInv = static_cast<T1>(1.0)/alpha;
+    uniformBlock(rng, u, n);
+    for (k = 0; k < n; ++k) {
+      g[k] *= bi::pow(u[k], alphaInv);
+    }
+  }
+}
+
+template<class T1>
+inline void bi::RandomHost::boxMuller(const T1* u, T1* z, const int n) {
+  const int m = n/2;
+  const T1 twopi = static_cast<T1>(BI_TWO_PI);
+  T1 r, a;
+  int k;
+
+  for (k = 0; k < m; ++k) {
+    r = bi::sqrt(static_cast<T1>(-2.0)*bi::log(u[k]));
+    a = twopi*u[m + k];
+    z[k] = r*bi::cos(a);
+    z[m + k] = r*bi::sin(a);
+  }
+}
+
+#ifdef ENABLE_SSE
+namespace bi {
+template<>
+inline void RandomHost::boxMuller<real>(const real* u, real* z, const int n) {
+  RandomSSE::boxMuller(u, z, n);
+}
+}
+#endif
+
 #endif
@@ -8,7 +8,11 @@
 #ifndef BI_HOST_RANDOM_RNG_HPP
 #define BI_HOST_RANDOM_RNG_HPP
 
+#ifdef ENABLE_PHILOX
+#include "Philox.hpp"
+#else
 #include "boost/random/mersenne_twister.hpp"
+#endif
 
 namespace bi {
 /**
@@ -17,7 +21,11 @@ namespace bi {
  * @ingroup math_rng
  *
  * Uses the Mersenne Twister algorithm for generating pseudorandom variates,
- * as implemented in Boost.Random.
+ * as implemented in Boost.Random, or, when compiled with
+ * @c ENABLE_PHILOX, the counter-based Philox4x32 generator. In the latter
+ * case, beginStream() selects a stream determined only by the seed, a
+ * particle index and a step, and seed() a default stream determined only by
+ * its arguments, so that variates do not depend on which thread draws them.
  *
  * @section RngHost_references References
  *
@@ -32,8 +40,30 @@ public:
    * Seed random number generator.
    *
    * @param seed Seed value.
+   * @param q Default stream, used outside of beginStream() and endStream().
+   *
+   * Under @c ENABLE_PHILOX, the variates depend only on @p seed and @p q,
+   * not on the thread that draws them. Otherwise @p q is ignored.
+   */
+  void seed(const unsigned seed, const unsigned q = 0);
+
+  /**
+   * Begin stream for a particular particle and step.
+   *
+   * @param p Particle index.
+   * @param t Step, as given by Random::step().
+   *
+   * Has no effect unless compiled with @c ENABLE_PHILOX.
+   */
+  void beginStream(const unsigned p, const unsigned t);
+
+  /**
+   * End stream, restoring the generator to its state before the first call
+   * to beginStream().
+   *
+   * Has no effect unless compiled with @c ENABLE_PHILOX.
    */
-  void seed(const unsigned seed);
+  void endStream();
 
   /**
    * @copydoc Random::uniformInt
@@ -68,12 +98,33 @@ public:
   /**
    * Random number generator type.
    */
+#ifdef ENABLE_PHILOX
+  typedef Philox4x32 rng_type;
+#else
   typedef boost::mt19937 rng_type;
+#endif
 
   /**
    * Random number generator.
    */
   rng_type rng;
+
+#ifdef ENABLE_PHILOX
+  /**
+   * Constructor.
+   */
+  RngHost();
+
+  /**
+   * Random number generator outside of streams.
+   */
+  rng_type rng0;
+
+  /**
+   * Is a stream in use?
+   */
+  bool streaming;
+#endif
 };
 }
 
@@ -88,10 +139,45 @@ public:
 
 #include "thrust/binary_search.h"
 
-inline void bi::RngHost::seed(const unsigned seed) {
+#ifdef ENABLE_PHILOX
+inline bi::RngHost::RngHost() : streaming(false) {
+  //
+}
+
+inline void bi::RngHost::seed(const unsigned seed, const unsigned q) {
   rng.seed(seed);
+  rng.stream(0xFFFFFFFFu, q);
+  streaming = false;
+}
+
+inline void bi::RngHost::beginStream(const unsigned p, const unsigned t) {
+  if (!streaming) {
+    rng0 = rng;
+    streaming = true;
+  }
+  rng.stream(p, t);
 }
 
+inline void bi::RngHost::endStream() {
+  if (streaming) {
+    rng = rng0;
+    streaming = false;
+  }
+}
+#else
+inline void bi::RngHost::seed(const unsigned seed, const unsigned q) {
+  rng.seed(seed);
+}
+
+inline void bi::RngHost::beginStream(const unsigned p, const unsigned t) {
+  //
+}
+
+inline void bi::RngHost::endStream() {
+  //
+}
+#endif
+
 template<class T1>
 inline T1 bi::RngHost::uniformInt(const T1 lower, const T1 upper) {
   /* pre-condition */
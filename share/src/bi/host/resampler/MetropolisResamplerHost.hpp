@@ -13,14 +13,17 @@ void bi::MetropolisResamplerHost::ancestors(Random& rng, const V1 lws,
     V2 as, int B) {
   const int P1 = lws.size(); // number of particles
   const int P2 = as.size(); // number of ancestors to draw
+  const unsigned t = rng.step();
 
   #pragma omp parallel
   {
+    RngHost& rng1 = rng.getHostRng();
     real alpha, lw1, lw2;
     int k, p1, p2, p;
 
     #pragma omp for
     for (p = 0; p < P2; ++p) {
+      rng1.beginStream(p, t);
       p1 = p;
       lw1 = lws(p);
       for (k = 0; k < B; ++k) {
@@ -38,6 +41,7 @@ void bi::MetropolisResamplerHost::ancestors(Random& rng, const V1 lws,
       /* write result */
       as(p) = p1;
     }
+    rng1.endStream();
   }
 }
 
@@ -48,4 +52,51 @@ void bi::MetropolisResamplerHost::ancestorsPermute(Random& rng, const V1 lws,
   permute(as);
 }
 
+template<class V1, class V2, class V3>
+void bi::MetropolisResamplerHost::ancestors(Random& rng, const V1 lws,
+    V2 as, const V3 Ps, int B) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == as.size());
+  BI_ASSERT(*(Ps.end() - 1) == lws.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
+
+  const int G = Ps.size() - 1;
+  const unsigned t = rng.step(G);  // one step per group
+
+  #pragma omp parallel
+  {
+    RngHost& rng1 = rng.getHostRng();
+    real alpha, lw1, lw2;
+    int g, k, p1, p2, p, q, n;
+
+    #pragma omp for schedule(dynamic)
+    for (g = 0; g < G; ++g) {
+      p = Ps(g);
+      n = Ps(g + 1) - p;
+      for (q = 0; q < n; ++q) {
+        rng1.beginStream(q, t + g);
+        p1 = q;
+        lw1 = lws(p + q);
+        for (k = 0; k < B; ++k) {
+          p2 = rng.uniformInt(0, n - 1);
+          lw2 = lws(p + p2);
+          alpha = rng.uniform<real>();
+
+          if (bi::log(alpha) < lw2 - lw1) {
+            /* accept */
+            p1 = p2;
+            lw1 = lw2;
+          }
+        }
+
+        /* write result */
+        as(p + q) = p + p1;
+      }
+    }
+    rng1.endStream();
+  }
+}
+
 #endif
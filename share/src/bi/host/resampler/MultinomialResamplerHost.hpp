@@ -58,4 +58,96 @@ void bi::MultinomialResamplerHost::ancestors(Random& rng, const V1 lws, V2 as,
   BI_ASSERT(max_reduce(as) < lws.size());
 }
 
+template<class V1, class V2, class V3>
+void bi::MultinomialResamplerHost::ancestors(Random& rng, const V1 lws,
+    V2 as, const V3 Ps, const bool sort)
+    throw (ParticleFilterDegeneratedException) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == as.size());
+  BI_ASSERT(*(Ps.end() - 1) == lws.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
+
+  typedef typename V1::value_type T1;
+  typedef typename temp_host_vector<T1>::type vector_type;
+  typedef typename temp_host_vector<int>::type int_vector_type;
+
+  const int G = Ps.size() - 1;
+  int g, i, p1, n, maxn = 0;
+
+  /* variates, drawn in group order as separate calls would on one thread,
+   * variate for step i of group g stored at Ps(g) + i - 1 */
+  vector_type us(lws.size());
+  for (g = 0; g < G; ++g) {
+    p1 = Ps(g);
+    n = Ps(g + 1) - p1;
+    maxn = bi::max(maxn, n);
+    for (i = n; i > 0; --i) {
+      us(p1 + i - 1) = rng.uniform<T1>();
+    }
+  }
+
+  /* workspace for each thread, sized for the largest group */
+  const int Q = bi_omp_max_threads*maxn;
+  vector_type Ws(Q), lws1(sort ? Q : 0);
+  int_vector_type ps(sort ? Q : 0);
+  bool degenerate = false;
+
+  #pragma omp parallel
+  {
+    const int q = bi_omp_tid*maxn;
+    int g1, i, j, p1, n;
+    T1 W, lW, lMax, lu;
+
+    #pragma omp for schedule(dynamic) reduction(||:degenerate)
+    for (g1 = 0; g1 < G; ++g1) {
+      p1 = Ps(g1);
+      n = Ps(g1 + 1) - p1;
+      if (n > 0) {
+        BOOST_AUTO(lws2, subrange(lws, p1, n));
+        BOOST_AUTO(Ws2, subrange(Ws, q, n));
+
+        if (sort) {
+          BOOST_AUTO(lws3, subrange(lws1, q, n));
+          BOOST_AUTO(ps2, subrange(ps, q, n));
+
+          lws3 = lws2;
+          seq_elements(ps2, 0);
+          bi::sort_by_key(lws3, ps2);
+          sumexpu_inclusive_scan(lws3, Ws2);
+        } else {
+          sumexpu_inclusive_scan(lws2, Ws2);
+        }
+
+        W = *(Ws2.end() - 1);  // sum of weights
+        if (W > 0) {
+          lW = bi::log(W);
+          lMax = 0.0;
+          j = n;
+          for (i = n; i > 0; --i) {
+            lMax += bi::log(us(p1 + i - 1))/i;
+            lu = lW + lMax;
+
+            while (j > 0 && lu < bi::log(Ws2(j - 1))) {
+              --j;
+            }
+            if (sort) {
+              as(p1 + i - 1) = p1 + ps(q + j);
+            } else {
+              as(p1 + i - 1) = p1 + j;
+            }
+          }
+        } else {
+          degenerate = true;
+        }
+      }
+    }
+  }
+
+  if (degenerate) {
+    throw ParticleFilterDegeneratedException();
+  }
+}
+
 #endif
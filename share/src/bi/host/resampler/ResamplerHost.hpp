@@ -9,6 +9,8 @@
 #define BI_HOST_RESAMPLER_RESAMPLERHOST_HPP
 
 #include "../../primitive/vector_primitive.hpp"
+#include "../../math/temp_vector.hpp"
+#include "../../misc/omp.hpp"
 
 template<class V1, class V2>
 void bi::ResamplerHost::ancestorsToOffspring(const V1 as, V2 os) {
@@ -93,34 +95,76 @@ void bi::ResamplerHost::cumulativeOffspringToAncestorsPermute(const V1 Os,
     V2 as) {
   /* pre-conditions */
   BI_ASSERT(*(Os.end() - 1) == as.size());
+  BI_ASSERT(Os.size() == as.size());
   BI_ASSERT(!V1::on_device);
   BI_ASSERT(!V2::on_device);
 
-  int i, j, k = 0, o, O1, O2;
-  for (i = 0; i < Os.size(); ++i) {
-    O1 = (i > 0) ? Os(i - 1) : 0;
-    O2 = Os(i);
-    o = O2 - O1;
+  typedef typename temp_host_vector<int>::type int_vector_type;
 
-    if (o > 0) {
-      as(i) = i;
-      --o;
-    }
+  const int P = as.size();
+  const int N = bi_omp_max_threads + 1;
+  int_vector_type gs(P), nes(N), ngs(N);
 
-    if (k == 0 && o > 0) { // deal with special case here rather than in loop
-      if (Os(k) > 0) {
-        ++k;
+  /*
+   * Particles with at least one offspring keep their own place, and the
+   * remaining offspring fill the places of those with none. The r-th such
+   * offspring, in order of ancestor, fills the r-th such place, in order of
+   * index, so that the result is the same as that of a sequential pass.
+   */
+  #pragma omp parallel
+  {
+    const int T = omp_get_num_threads();
+    const int tid = omp_get_thread_num();
+    const int i1 = static_cast<int>(static_cast<long>(P)*tid/T);
+    const int i2 = static_cast<int>(static_cast<long>(P)*(tid + 1)/T);
+    int i, j, o, ne, ng;
+
+    /* count surplus offspring and empty places in block */
+    ne = 0;
+    ng = 0;
+    for (i = i1; i < i2; ++i) {
+      o = Os(i) - ((i > 0) ? Os(i - 1) : 0);
+      if (o > 0) {
+        ne += o - 1;
       } else {
-        as(k++) = i;
-        --o;
+        ++ng;
       }
     }
+    nes(tid + 1) = ne;
+    ngs(tid + 1) = ng;
 
-    for (j = 0; j < o; ++j) {
-      while (Os(k) - Os(k - 1) > 0) {
-        ++k;
+    /* exclusive scan of counts across blocks */
+    #pragma omp barrier
+    #pragma omp single
+    {
+      nes(0) = 0;
+      ngs(0) = 0;
+      for (j = 1; j <= T; ++j) {
+        nes(j) += nes(j - 1);
+        ngs(j) += ngs(j - 1);
+      }
+    }
+
+    /* list empty places */
+    ng = ngs(tid);
+    for (i = i1; i < i2; ++i) {
+      o = Os(i) - ((i > 0) ? Os(i - 1) : 0);
+      if (o == 0) {
+        gs(ng++) = i;
+      }
+    }
+    #pragma omp barrier
+
+    /* fill */
+    ne = nes(tid);
+    for (i = i1; i < i2; ++i) {
+      o = Os(i) - ((i > 0) ? Os(i - 1) : 0);
+      if (o > 0) {
+        as(i) = i;
+        for (j = 1; j < o; ++j) {
+          as(gs(ne++)) = i;
+        }
       }
-      as(k++) = i;
     }
   }
 }
@@ -130,19 +174,248 @@ void bi::ResamplerHost::permute(V1 as) {
   /* pre-condition */
   BI_ASSERT(!V1::on_device);
 
+  typedef typename temp_host_vector<int>::type int_vector_type;
+  typedef typename V1::value_type T1;
+
   const int P = as.size();
+  const int N = bi_omp_max_threads + 1;
+  int_vector_type os(P), gs(P), bs(P), nes(N), ngs(N), nbs(N);
+
+  /*
+   * As cumulativeOffspringToAncestorsPermute(), but with offspring counted
+   * from the ancestry. Ancestors outside the range of places (i.e. no less
+   * than the number of particles) are surplus, and fill the empty places
+   * remaining after those of ancestors within range, in order of index.
+   */
+  os.clear();
+  #pragma omp parallel
+  {
+    const int T = omp_get_num_threads();
+    const int tid = omp_get_thread_num();
+    const int i1 = static_cast<int>(static_cast<long>(P)*tid/T);
+    const int i2 = static_cast<int>(static_cast<long>(P)*(tid + 1)/T);
+    int i, j, o, ne, ng, nb;
+    T1 k;
+
+    /* count offspring */
+    #pragma omp for
+    for (i = 0; i < P; ++i) {
+      k = as(i);
+      if (k < P) {
+        #pragma omp atomic
+        ++os(k);
+      }
+    }
+
+    /* count surplus offspring, empty places and out of range ancestors in
+     * block */
+    ne = 0;
+    ng = 0;
+    nb = 0;
+    for (i = i1; i < i2; ++i) {
+      o = os(i);
+      if (o > 0) {
+        ne += o - 1;
+      } else {
+        ++ng;
+      }
+      if (as(i) >= P) {
+        ++nb;
+      }
+    }
+    nes(tid + 1) = ne;
+    ngs(tid + 1) = ng;
+    nbs(tid + 1) = nb;
+
+    /* exclusive scan of counts across blocks */
+    #pragma omp barrier
+    #pragma omp single
+    {
+      nes(0) = 0;
+      ngs(0) = 0;
+      nbs(0) = 0;
+      for (j = 1; j <= T; ++j) {
+        nes(j) += nes(j - 1);
+        ngs(j) += ngs(j - 1);
+        nbs(j) += nbs(j - 1);
+      }
+    }
+
+    /* list empty places, and set aside out of range ancestors, as their
+     * places may be overwritten below */
+    ng = ngs(tid);
+    nb = nbs(tid);
+    for (i = i1; i < i2; ++i) {
+      if (os(i) == 0) {
+        gs(ng++) = i;
+      }
+      if (as(i) >= P) {
+        bs(nb++) = as(i);
+      }
+    }
+    #pragma omp barrier
+
+    /* fill */
+    ne = nes(tid);
+    for (i = i1; i < i2; ++i) {
+      o = os(i);
+      if (o > 0) {
+        as(i) = i;
+        for (j = 1; j < o; ++j) {
+          as(gs(ne++)) = i;
+        }
+      }
+    }
+    ne = nes(T);
+    for (nb = nbs(tid); nb < nbs(tid + 1); ++nb) {
+      as(gs(ne + nb)) = bs(nb);
+    }
+  }
+}
+
+template<class V1, class V2, class V3>
+void bi::ResamplerHost::cumulativeOffspringToAncestors(const V1 Os, V2 as,
+    const V3 Ps) {
+  /* pre-conditions */
+  BI_ASSERT(Os.size() == as.size());
+  BI_ASSERT(*(Ps.end() - 1) == as.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
+
+  const int G = Ps.size() - 1;
+
+  #pragma omp parallel
+  {
+    int g, i, j, p1, p2, O1, o;
+
+    #pragma omp for
+    for (g = 0; g < G; ++g) {
+      p1 = Ps(g);
+      p2 = Ps(g + 1);
+      for (i = p1; i < p2; ++i) {
+        O1 = (i > p1) ? Os(i - 1) : 0;
+        o = Os(i) - O1;
+        for (j = 0; j < o; ++j) {
+          as(p1 + O1 + j) = i;
+        }
+      }
+    }
+  }
+}
+
+template<class V1, class V2, class V3>
+void bi::ResamplerHost::cumulativeOffspringToAncestorsPermute(const V1 Os,
+    V2 as, const V3 Ps) {
+  /* pre-conditions */
+  BI_ASSERT(Os.size() == as.size());
+  BI_ASSERT(*(Ps.end() - 1) == as.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
 
-  typename V1::size_type i;
-  typename V1::value_type j, k;
-
-  for (i = 0; i < as.size(); ++i) {
-    k = as(i);
-    if (k < P && k != i && as(k) != k) {
-      /* swap */
-      j = as(k);
-      as(k) = k;
-      as(i) = j;
-      --i; // repeat for new value
+  const int G = Ps.size() - 1;
+
+  /*
+   * Within each group, a sequential pass of the same rule as the parallel
+   * cumulativeOffspringToAncestorsPermute(), so that results agree.
+   */
+  #pragma omp parallel
+  {
+    int g, i, j, k, p1, p2, o;
+
+    #pragma omp for
+    for (g = 0; g < G; ++g) {
+      p1 = Ps(g);
+      p2 = Ps(g + 1);
+      k = p1;
+      for (i = p1; i < p2; ++i) {
+        o = Os(i) - ((i > p1) ? Os(i - 1) : 0);
+        if (o > 0) {
+          as(i) = i;
+          --o;
+        }
+        for (j = 0; j < o; ++j) {
+          while (Os(k) - ((k > p1) ? Os(k - 1) : 0) > 0) {
+            ++k;
+          }
+          as(k++) = i;
+        }
+      }
+    }
+  }
+}
+
+template<class V1, class V2, class V3>
+void bi::ResamplerHost::cumulativeOffspringToOffspring(const V1 Os, V2 os,
+    const V3 Ps) {
+  /* pre-conditions */
+  BI_ASSERT(Os.size() == os.size());
+  BI_ASSERT(*(Ps.end() - 1) == os.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
+
+  const int G = Ps.size() - 1;
+
+  #pragma omp parallel
+  {
+    int g, i, p1, p2;
+
+    #pragma omp for
+    for (g = 0; g < G; ++g) {
+      p1 = Ps(g);
+      p2 = Ps(g + 1);
+      for (i = p1; i < p2; ++i) {
+        os(i) = Os(i) - ((i > p1) ? Os(i - 1) : 0);
+      }
+    }
+  }
+}
+
+template<class V1, class V2>
+void bi::ResamplerHost::permute(V1 as, const V2 Ps) {
+  /* pre-conditions */
+  BI_ASSERT(*(Ps.end() - 1) == as.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+
+  typedef typename temp_host_vector<int>::type int_vector_type;
+
+  const int G = Ps.size() - 1;
+  int_vector_type os(as.size());
+
+  /* as cumulativeOffspringToAncestorsPermute(), with offspring counted from
+   * the ancestry of each group */
+  #pragma omp parallel
+  {
+    int g, i, j, k, p1, p2, o;
+
+    #pragma omp for
+    for (g = 0; g < G; ++g) {
+      p1 = Ps(g);
+      p2 = Ps(g + 1);
+      for (i = p1; i < p2; ++i) {
+        os(i) = 0;
+      }
+      for (i = p1; i < p2; ++i) {
+        BI_ASSERT(as(i) >= p1 && as(i) < p2);
+        ++os(as(i));
+      }
+      k = p1;
+      for (i = p1; i < p2; ++i) {
+        o = os(i);
+        if (o > 0) {
+          as(i) = i;
+          --o;
+        }
+        for (j = 0; j < o; ++j) {
+          while (os(k) > 0) {
+            ++k;
+          }
+          as(k++) = i;
+        }
+      }
     }
   }
 }
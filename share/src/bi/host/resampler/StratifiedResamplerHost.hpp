@@ -34,6 +34,8 @@ void bi::StratifiedResamplerHost::op(Random& rng, const V1 Ws, V2 Os,
   typedef typename V1::value_type T1;
   typedef boost::uniform_real<T1> dist_type;
 
+  const unsigned t = rng.step();
+
   #pragma omp parallel
   {
     RngHost& rng1 = rng.getHostRng();
@@ -44,8 +46,10 @@ void bi::StratifiedResamplerHost::op(Random& rng, const V1 Ws, V2 Os,
 
     #pragma omp for
     for (i = 0; i < alphas.size(); ++i) {
+      rng1.beginStream(i, t);
       alphas(i) = gen();
     }
+    rng1.endStream();
 
     #pragma omp barrier
 
@@ -59,4 +63,110 @@ void bi::StratifiedResamplerHost::op(Random& rng, const V1 Ws, V2 Os,
   }
 }
 
+template<class V1, class V2, class V3>
+void bi::StratifiedResamplerHost::cumulativeOffspring(Random& rng,
+    const V1 lws, V2 Os, const V3 Ps, const bool sort)
+    throw (ParticleFilterDegeneratedException) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == Os.size());
+  BI_ASSERT(*(Ps.end() - 1) == lws.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
+
+  typedef typename V1::value_type T1;
+  typedef typename temp_host_vector<T1>::type vector_type;
+  typedef typename temp_host_vector<int>::type int_vector_type;
+  typedef boost::uniform_real<T1> dist_type;
+
+  const int G = Ps.size() - 1;
+  int g, maxn = 0;
+  for (g = 0; g < G; ++g) {
+    maxn = bi::max(maxn, Ps(g + 1) - Ps(g));
+  }
+
+  /* one step per group, as separate calls would take */
+  const unsigned t = rng.step(G);
+
+  /* workspace for each thread, sized for the largest group */
+  const int Q = bi_omp_max_threads*maxn;
+  vector_type Ws(Q), alphas(Q), lws1(sort ? Q : 0);
+  int_vector_type Os1(Q), ps(sort ? Q : 0), temp(sort ? Q : 0);
+  bool degenerate = false;
+
+  #pragma omp parallel
+  {
+    RngHost& rng1 = rng.getHostRng();
+    const int q = bi_omp_tid*maxn;
+    int g1, i, k, p1, n;
+    T1 W, reach;
+
+    dist_type dist(0.0, 1.0);
+    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
+
+    #pragma omp for schedule(dynamic) reduction(||:degenerate)
+    for (g1 = 0; g1 < G; ++g1) {
+      p1 = Ps(g1);
+      n = Ps(g1 + 1) - p1;
+      if (n > 0) {
+        BOOST_AUTO(lws2, subrange(lws, p1, n));
+        BOOST_AUTO(Os2, subrange(Os, p1, n));
+        BOOST_AUTO(Ws2, subrange(Ws, q, n));
+        BOOST_AUTO(alphas2, subrange(alphas, q, n));
+
+        if (sort) {
+          BOOST_AUTO(lws3, subrange(lws1, q, n));
+          BOOST_AUTO(ps2, subrange(ps, q, n));
+
+          lws3 = lws2;
+          seq_elements(ps2, 0);
+          bi::sort_by_key(lws3, ps2);
+          sumexpu_inclusive_scan(lws3, Ws2);
+        } else {
+          sumexpu_inclusive_scan(lws2, Ws2);
+        }
+
+        W = *(Ws2.end() - 1);  // sum of weights
+        if (W > 0) {
+          for (i = 0; i < n; ++i) {
+            rng1.beginStream(i, t + g1);
+            alphas2(i) = gen();
+          }
+          rng1.endStream();
+
+          BOOST_AUTO(Os3, subrange(Os1, q, n));
+          for (i = 0; i < n; ++i) {
+            reach = Ws2(i)/W*n;
+            k = bi::min(n - 1, static_cast<int>(reach));
+            Os3(i) = bi::min(n, static_cast<int>(reach + alphas2(k)));
+          }
+
+          if (sort) {
+            BOOST_AUTO(ps2, subrange(ps, q, n));
+            BOOST_AUTO(temp2, subrange(temp, q, n));
+
+            bi::adjacent_difference(Os3, temp2);
+            bi::scatter(ps2, temp2, Os2);
+            sum_inclusive_scan(Os2, Os2);
+          } else {
+            Os2 = Os3;
+          }
+
+#ifndef NDEBUG
+          int m = *(Os2.end() - 1);
+          BI_ASSERT_MSG(m == n, "Stratified resampler gives " << m <<
+              " offspring, should give " << n);
+#endif
+        } else {
+          degenerate = true;
+        }
+      }
+    }
+  }
+
+  if (degenerate) {
+    throw ParticleFilterDegeneratedException();
+  }
+}
+
 #endif
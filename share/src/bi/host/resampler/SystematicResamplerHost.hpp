@@ -0,0 +1,105 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_RESAMPLER_SYSTEMATICRESAMPLERHOST_HPP
+#define BI_HOST_RESAMPLER_SYSTEMATICRESAMPLERHOST_HPP
+
+template<class V1, class V2, class V3>
+void bi::SystematicResamplerHost::cumulativeOffspring(Random& rng,
+    const V1 lws, V2 Os, const V3 Ps, const bool sort)
+    throw (ParticleFilterDegeneratedException) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == Os.size());
+  BI_ASSERT(*(Ps.end() - 1) == lws.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
+
+  typedef typename V1::value_type T1;
+  typedef typename temp_host_vector<T1>::type vector_type;
+  typedef typename temp_host_vector<int>::type int_vector_type;
+
+  const int G = Ps.size() - 1;
+  int g, maxn = 0;
+  for (g = 0; g < G; ++g) {
+    maxn = bi::max(maxn, Ps(g + 1) - Ps(g));
+  }
+
+  /* offsets into strata, drawn in group order as separate calls would */
+  vector_type alphas(G);
+  for (g = 0; g < G; ++g) {
+    alphas(g) = rng.uniform((T1)0.0, (T1)1.0);
+  }
+
+  /* workspace for each thread, sized for the largest group */
+  const int Q = bi_omp_max_threads*maxn;
+  vector_type Ws(Q), lws1(sort ? Q : 0);
+  int_vector_type ps(sort ? Q : 0), Os1(sort ? Q : 0), temp(sort ? Q : 0);
+  bool degenerate = false;
+
+  #pragma omp parallel
+  {
+    const int q = bi_omp_tid*maxn;
+    int g1, p1, n;
+    T1 W;
+
+    #pragma omp for schedule(dynamic) reduction(||:degenerate)
+    for (g1 = 0; g1 < G; ++g1) {
+      p1 = Ps(g1);
+      n = Ps(g1 + 1) - p1;
+      if (n > 0) {
+        BOOST_AUTO(lws2, subrange(lws, p1, n));
+        BOOST_AUTO(Os2, subrange(Os, p1, n));
+        BOOST_AUTO(Ws2, subrange(Ws, q, n));
+
+        if (sort) {
+          BOOST_AUTO(lws3, subrange(lws1, q, n));
+          BOOST_AUTO(ps2, subrange(ps, q, n));
+
+          lws3 = lws2;
+          seq_elements(ps2, 0);
+          bi::sort_by_key(lws3, ps2);
+          sumexpu_inclusive_scan(lws3, Ws2);
+        } else {
+          sumexpu_inclusive_scan(lws2, Ws2);
+        }
+
+        W = *(Ws2.end() - 1);  // sum of weights
+        if (W > 0) {
+          if (sort) {
+            BOOST_AUTO(ps2, subrange(ps, q, n));
+            BOOST_AUTO(Os3, subrange(Os1, q, n));
+            BOOST_AUTO(temp2, subrange(temp, q, n));
+
+            op_elements(Ws2, Os3,
+                resample_cumulative_offspring<T1>(alphas(g1), W, n));
+            bi::adjacent_difference(Os3, temp2);
+            bi::scatter(ps2, temp2, Os2);
+            sum_inclusive_scan(Os2, Os2);
+          } else {
+            op_elements(Ws2, Os2,
+                resample_cumulative_offspring<T1>(alphas(g1), W, n));
+          }
+
+#ifndef NDEBUG
+          int m = *(Os2.end() - 1);
+          BI_ASSERT_MSG(m == n, "Systematic resampler gives " << m <<
+              " offspring, should give " << n);
+#endif
+        } else {
+          degenerate = true;
+        }
+      }
+    }
+  }
+
+  if (degenerate) {
+    throw ParticleFilterDegeneratedException();
+  }
+}
+
+#endif
@@ -58,6 +58,8 @@ void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
+  const unsigned t = rng.step();
+
   #pragma omp parallel
   {
     PX pax;
@@ -67,8 +69,10 @@ void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
 
     #pragma omp for
     for (p = 0; p < s.size(); ++p) {
+      rng1.beginStream(s.start() + p, t);
       Visitor::accept(rng1, t1, t2, s, p, pax, x);
     }
+    rng1.endStream();
   }
 }
 
@@ -9,6 +9,7 @@
 #define BI_HOST_UPDATER_SPARSESTATICLOGDENSITYHOST_HPP
 
 #include "../../state/State.hpp"
+#include "../../resampler/WeightStats.hpp"
 
 namespace bi {
 /**
@@ -35,6 +36,16 @@ public:
   template<class V1>
   static void logDensities(State<B,ON_HOST>& s, const int p,
       const Mask<ON_HOST>& mask, V1 lp);
+
+  /**
+   * @copydoc SparseStaticLogDensity::logSumExpDensities(State<B,ON_HOST>&, const Mask<ON_HOST>&, V1)
+   *
+   * The statistics are accumulated as each log-density is computed, in the
+   * same pass over trajectories.
+   */
+  template<class V1>
+  static WeightStats logSumExpDensities(State<B,ON_HOST>& s,
+      const Mask<ON_HOST>& mask, V1 lp);
 };
 }
 
@@ -85,4 +96,39 @@ void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
   Visitor::accept(mask, s, p, pax, x, lp(p));
 }
 
+template<class B, class S>
+template<class V1>
+bi::WeightStats bi::SparseStaticLogDensityHost<B,S>::logSumExpDensities(
+    State<B,ON_HOST>& s, const Mask<ON_HOST>& mask, V1 lp) {
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef Ou<ON_HOST,B,host> OX;
+  typedef SparseStaticLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
+  typedef SparseStaticLogDensityVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  WeightStats ws;
+
+  #pragma omp parallel
+  {
+    PX pax;
+    OX x;
+    WeightStats ws1;
+    int p;
+
+    #pragma omp for
+    for (p = 0; p < s.size(); ++p) {
+      Visitor::accept(mask, s, p, pax, x, lp(p));
+      ws1.add(lp(p));
+    }
+
+    #pragma omp critical
+    {
+      ws.merge(ws1);
+    }
+  }
+
+  return ws;
+}
+
 #endif
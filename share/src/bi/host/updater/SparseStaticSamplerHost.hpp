@@ -55,6 +55,8 @@ void bi::SparseStaticSamplerHost<B,S>::samples(Random& rng,
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
+  const unsigned t = rng.step();
+
 #pragma omp parallel
   {
     PX pax;
@@ -64,8 +66,10 @@ void bi::SparseStaticSamplerHost<B,S>::samples(Random& rng,
 
 #pragma omp for
     for (p = 0; p < s.size(); ++p) {
+      rng1.beginStream(s.start() + p, t);
       Visitor::accept(rng, s, mask, p, pax, x);
     }
+    rng1.endStream();
   }
 }
 
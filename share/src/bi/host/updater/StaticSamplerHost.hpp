@@ -52,6 +52,8 @@ void bi::StaticSamplerHost<B,S>::samples(Random& rng, State<B,ON_HOST>& s) {
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
+  const unsigned t = rng.step();
+
 #pragma omp parallel
   {
     PX pax;
@@ -61,8 +63,10 @@ void bi::StaticSamplerHost<B,S>::samples(Random& rng, State<B,ON_HOST>& s) {
 
 #pragma omp for
     for (p = 0; p < s.size(); ++p) {
+      rng1.beginStream(s.start() + p, t);
       Visitor::accept(rng1, s, p, pax, x);
     }
+    rng1.endStream();
   }
 }
 
@@ -21,17 +21,14 @@ void bi_init(const int threads = 0);
 
 #include "cuda/cuda.hpp"
 #include "misc/omp.hpp"
-#include "ode/IntegratorConstants.hpp"
 #include "cuda/device.hpp"
 
 #ifdef ENABLE_MPI
 #include "boost/mpi.hpp"
 #endif
 
-// need to keep in same compilation unit as caller for bi_ode_init()
 void bi::bi_init(const int threads) {
   bi_omp_init(threads);
-  bi_ode_init();
   #ifdef ENABLE_CUDA
   cudaThreadSetCacheConfig(cudaFuncCachePreferL1);
   #ifdef ENABLE_MPI
@@ -496,6 +496,7 @@ bool bi::AuxiliaryParticleFilter<B,S,R,IO1>::resample(Random& rng,
               this->getSim()->getObs()->getMask(now.indexObs())));
     }
     this->getResam()->resample(rng, lw1s, lw2s, as, s);
+    this->getResam()->finish(as, s);
   } else {
     seq_elements(as, 0);
     Resampler::normalise(lw2s);
@@ -522,6 +523,7 @@ bool bi::AuxiliaryParticleFilter<B,S,R,IO1>::resample(Random& rng,
               this->getSim()->getObs()->getMask(now.indexObs())));
     }
     this->getResam()->resample(rng, a, lw1s, lw2s, as, s);
+    this->getResam()->finish(as, s);
   } else {
     seq_elements(as, 0);
     Resampler::normalise(lw2s);
@@ -9,7 +9,10 @@
 #define BI_METHOD_FORCER_HPP
 
 #include "../buffer/SparseInputNetCDFBuffer.hpp"
+#include "../buffer/SparseInputStore.hpp"
 #include "../cache/Cache2D.hpp"
+#include "../state/ScheduleIterator.hpp"
+#include "../misc/BackgroundThread.hpp"
 
 namespace bi {
 /**
@@ -28,6 +31,12 @@ namespace bi {
  * it in a valid state, unless that State object was in a valid state for
  * the previous time index. It is up to the user of the class to maintain
  * these semantics.
+ *
+ * Inputs are read on first use by default. For a run that does not stop
+ * on I/O, all inputs may instead be read at once with preload(), or read
+ * some way ahead of their use by a background thread with prefetch().
+ * Alternatively, inputs may be read from a SparseInputStore shared with
+ * other processes, see setStore(), in which case neither is necessary.
  */
 template<class IO1 = SparseInputNetCDFBuffer, Location CL = ON_HOST>
 class Forcer {
@@ -39,6 +48,28 @@ public:
    */
   Forcer(IO1* in);
 
+  /**
+   * Destructor.
+   */
+  ~Forcer();
+
+  /**
+   * Get store.
+   */
+  SparseInputStore* getStore();
+
+  /**
+   * Set store.
+   *
+   * @param store Store from which to read inputs in place of @c in, or NULL
+   * to read from @c in. Caller retains ownership.
+   *
+   * Inputs are then read from the store directly, and not cached. The
+   * store rebuilds the full vector of inputs at any time, so that update()
+   * gives the same state as with the cache, whatever the order of times.
+   */
+  void setStore(SparseInputStore* store);
+
   /**
    * Update dynamic inputs.
    *
@@ -62,12 +93,106 @@ public:
   template<class B, Location L>
   void update0(State<B,L>& s);
 
+  /**
+   * Read all inputs of a time schedule into the cache.
+   *
+   * @tparam B Model type.
+   * @tparam L Location.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State, used as workspace. Its inputs are overwritten.
+   *
+   * The inputs are read in the order of the schedule, as the first pass
+   * of a simulation would read them, so that the cache holds the same
+   * values as after that pass.
+   *
+   * Does nothing, beyond updating static inputs, if a store is set.
+   */
+  template<class B, Location L>
+  void preload(const ScheduleIterator first, const ScheduleIterator last,
+      State<B,L>& s);
+
+  /**
+   * Read the inputs of a time schedule into the cache in the background.
+   *
+   * @tparam B Model type.
+   * @tparam L Location.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State, used as workspace. Its inputs are overwritten.
+   * @param lookahead Number of input times to read at once.
+   * @param thread Thread on which to read. It may be shared with an
+   * Observer, but with no other user of NetCDF, and must be idle when this
+   * object is destroyed.
+   *
+   * Static inputs are read immediately. Dynamic inputs are then read on
+   * @p thread in windows of @p lookahead times: when update() first reaches
+   * a window, it waits for that window to finish and starts on the next,
+   * so that reads stay one window ahead of their use. Only update() should
+   * be used to read inputs from @p in until the thread is idle again.
+   *
+   * Under ENABLE_CUDA, or with caches on device, this is the same as
+   * preload(), as the temporaries used in reading are not safe to
+   * allocate from a thread other than the OpenMP threads.
+   *
+   * Does nothing, beyond updating static inputs, if a store is set.
+   */
+  template<class B, Location L>
+  void prefetch(const ScheduleIterator first, const ScheduleIterator last,
+      State<B,L>& s, const int lookahead, BackgroundThread* thread);
+
 private:
+  /**
+   * Job to read a window of dynamic inputs.
+   */
+  class PrefetchJob: public BackgroundJob {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param forcer Owner.
+     * @param x Inputs before the first window.
+     */
+    template<class V1>
+    PrefetchJob(Forcer<IO1,CL>* forcer, const V1 x);
+
+    virtual void run();
+
+    /**
+     * Owner.
+     */
+    Forcer<IO1,CL>* forcer;
+
+    /**
+     * Workspace, carrying inputs from one window to the next.
+     */
+    host_matrix<real> X;
+
+    /**
+     * Window, as a range of #ks.
+     */
+    int start, end;
+  };
+
+  /**
+   * Wait for prefetching of time index, if necessary.
+   *
+   * @param k Time index.
+   */
+  void fetch(const int k);
+
   /**
    * Input.
    */
   IO1* in;
 
+  /**
+   * Store, NULL if none.
+   */
+  SparseInputStore* store;
+
   /**
    * Cache of dynamic inputs.
    */
@@ -77,6 +202,36 @@ private:
    * Cache of static inputs.
    */
   Cache2D<real,CL> cache0;
+
+  /**
+   * Prefetch thread, NULL if not prefetching.
+   */
+  BackgroundThread* thread;
+
+  /**
+   * Prefetch job.
+   */
+  PrefetchJob* job;
+
+  /**
+   * Time indices to prefetch, in order of use.
+   */
+  std::vector<int> ks;
+
+  /**
+   * Number of time indices in #ks that are in the cache.
+   */
+  int ready;
+
+  /**
+   * Number of time indices in #ks that are in the cache or being read.
+   */
+  int pending;
+
+  /**
+   * Number of time indices to read at once.
+   */
+  int lookahead;
 };
 
 /**
@@ -107,16 +262,38 @@ struct ForcerFactory {
 }
 
 template<class IO1, bi::Location CL>
-bi::Forcer<IO1,CL>::Forcer(IO1* in) : in(in) {
+bi::Forcer<IO1,CL>::Forcer(IO1* in) : in(in), store(NULL), thread(NULL),
+    job(NULL), ready(0), pending(0), lookahead(0) {
   //
 }
 
+template<class IO1, bi::Location CL>
+bi::Forcer<IO1,CL>::~Forcer() {
+  delete job;
+}
+
+template<class IO1, bi::Location CL>
+inline bi::SparseInputStore* bi::Forcer<IO1,CL>::getStore() {
+  return store;
+}
+
+template<class IO1, bi::Location CL>
+inline void bi::Forcer<IO1,CL>::setStore(SparseInputStore* store) {
+  this->store = store;
+}
+
 template<class IO1, bi::Location CL>
 template<class B, bi::Location L>
 inline void bi::Forcer<IO1,CL>::update(const int k, State<B,L>& s) {
-  if (cache.isValid(k)) {
+  fetch(k);
+  if (store != NULL) {
+    store->read(k, F_VAR, s.get(F_VAR));
+  } else if (cache.isValid(k)) {
     vec(s.get(F_VAR)) = cache.get(k);
   } else {
+    if (thread != NULL) {
+      thread->wait();
+    }
     in->read(k, F_VAR, s.get(F_VAR));
     cache.set(k, vec(s.get(F_VAR)));
   }
@@ -125,12 +302,109 @@ inline void bi::Forcer<IO1,CL>::update(const int k, State<B,L>& s) {
 template<class IO1, bi::Location CL>
 template<class B, bi::Location L>
 inline void bi::Forcer<IO1,CL>::update0(State<B,L>& s) {
-  if (cache0.isValid(0)) {
+  if (store != NULL) {
+    store->read0(F_VAR, s.get(F_VAR));
+  } else if (cache0.isValid(0)) {
     vec(s.get(F_VAR)) = cache0.get(0);
   } else {
+    if (thread != NULL) {
+      thread->wait();
+    }
     in->read0(F_VAR, s.get(F_VAR));
     cache0.set(0, vec(s.get(F_VAR)));
   }
 }
 
+template<class IO1, bi::Location CL>
+template<class B, bi::Location L>
+void bi::Forcer<IO1,CL>::preload(const ScheduleIterator first,
+    const ScheduleIterator last, State<B,L>& s) {
+  ScheduleIterator iter;
+
+  update0(s);
+  if (store != NULL) {
+    return;
+  }
+  for (iter = first; iter != last; ++iter) {
+    if (iter->hasInput()) {
+      update(iter->indexInput(), s);
+    }
+  }
+}
+
+template<class IO1, bi::Location CL>
+template<class B, bi::Location L>
+void bi::Forcer<IO1,CL>::prefetch(const ScheduleIterator first,
+    const ScheduleIterator last, State<B,L>& s, const int lookahead,
+    BackgroundThread* thread) {
+  /* pre-conditions */
+  BI_ASSERT(lookahead > 0);
+  BI_ASSERT(thread != NULL);
+  BI_ASSERT(this->thread == NULL);
+
+#ifdef ENABLE_CUDA
+  preload(first, last, s);
+#else
+  if (CL == ON_DEVICE || store != NULL) {
+    preload(first, last, s);
+  } else {
+    ScheduleIterator iter;
+    for (iter = first; iter != last; ++iter) {
+      if (iter->hasInput() && (ks.empty() ||
+          iter->indexInput() != ks.back())) {
+        ks.push_back(iter->indexInput());
+      }
+    }
+    update0(s);
+  }
+  if (!ks.empty()) {
+    job = new PrefetchJob(this, vec(s.get(F_VAR)));
+
+    /* size the cache up front, so that the thread never reallocates it */
+    const int K = in->getTimes().size();
+    cache.resize(job->X.size2(), bi::max(cache.size(), K));
+
+    this->thread = thread;
+    this->lookahead = lookahead;
+    ready = 0;
+    pending = bi::min(lookahead, (int)ks.size());
+    job->start = ready;
+    job->end = pending;
+    thread->submit(job);
+  }
+#endif
+}
+
+template<class IO1, bi::Location CL>
+void bi::Forcer<IO1,CL>::fetch(const int k) {
+  while (ready < (int)ks.size() && k >= ks[ready]) {
+    /* reached the window being read, wait for it and start on the next */
+    thread->wait();
+    ready = pending;
+    if (pending < (int)ks.size()) {
+      pending = bi::min(pending + lookahead, (int)ks.size());
+      job->start = ready;
+      job->end = pending;
+      thread->submit(job);
+    }
+  }
+}
+
+template<class IO1, bi::Location CL>
+template<class V1>
+bi::Forcer<IO1,CL>::PrefetchJob::PrefetchJob(Forcer<IO1,CL>* forcer,
+    const V1 x) : forcer(forcer), X(1, x.size()), start(0), end(0) {
+  row(X, 0) = x;
+}
+
+template<class IO1, bi::Location CL>
+void bi::Forcer<IO1,CL>::PrefetchJob::run() {
+  int i, k;
+  for (i = start; i < end; ++i) {
+    k = forcer->ks[i];
+    forcer->in->read(k, F_VAR, X);
+    forcer->cache.set(k, row(X, 0));
+  }
+}
+
 #endif
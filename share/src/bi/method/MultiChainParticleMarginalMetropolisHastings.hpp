@@ -0,0 +1,466 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_METHOD_MULTICHAINPARTICLEMARGINALMETROPOLISHASTINGS_HPP
+#define BI_METHOD_MULTICHAINPARTICLEMARGINALMETROPOLISHASTINGS_HPP
+
+#include "ParticleMarginalMetropolisHastings.hpp"
+#include "../state/Schedule.hpp"
+#include "../state/ThetaState.hpp"
+#include "../cache/ParticleMCMCCache.hpp"
+#include "../random/Random.hpp"
+#include "../misc/location.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Particle Marginal Metropolis-Hastings (PMMH) sampler running multiple
+ * independent chains concurrently.
+ *
+ * @ingroup method
+ *
+ * @tparam B Model type
+ * @tparam F Filter type.
+ * @tparam IO1 Output type.
+ *
+ * Each chain has its own filter, state and random number generator, but all
+ * share the one model, simulator, inputs and observations. Chains are
+ * distributed across host threads, with each chain run single-threaded, so
+ * that the PRNG of each chain is used only by the thread that owns it.
+ * Chains are advanced in lock step, one PMMH step at a time, and the
+ * results of each step written to the one output, interleaved such that
+ * sample @c c of chain @c n has index <tt>c*N + n</tt>, where @c N is the
+ * number of chains.
+ *
+ * The first chain is always initialised alone, before the rest. As this
+ * runs the filter across the whole time schedule, it populates the caches
+ * of the shared Forcer and Observer objects, after which they are only read
+ * and so may be used from multiple threads. The remaining chains then share
+ * the initialisation file, which Simulator::init() reads one thread at a
+ * time.
+ */
+template<class B, class F, class IO1 = ParticleMCMCCache<> >
+class MultiChainParticleMarginalMetropolisHastings {
+public:
+  /**
+   * Chain type.
+   */
+  typedef ParticleMarginalMetropolisHastings<B,F> chain_type;
+
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param filters Filters, one per chain. Each must have its own output,
+   * but may share a simulator with the others.
+   * @param out Output.
+   */
+  MultiChainParticleMarginalMetropolisHastings(B& m,
+      const std::vector<F*>& filters, IO1* out = NULL);
+
+  /**
+   * Destructor.
+   */
+  ~MultiChainParticleMarginalMetropolisHastings();
+
+  /**
+   * @name High-level interface.
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * Get number of chains.
+   */
+  int getNumChains() const;
+
+  /**
+   * Get chain.
+   *
+   * @param n Chain index.
+   *
+   * @return Chain.
+   */
+  chain_type* getChain(const int n);
+
+  /**
+   * Get output.
+   *
+   * @return Output.
+   */
+  IO1* getOutput();
+
+  /**
+   * Set output.
+   *
+   * @param out Output buffer.
+   */
+  void setOutput(IO1* out);
+
+  /**
+   * Sample.
+   *
+   * @tparam L Location.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator. Used only to seed the
+   * random number generators of the individual chains.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param s Prototype state. The state of each chain is constructed from
+   * this.
+   * @param inInit Initialisation file.
+   * @param C Number of samples to draw in each chain.
+   * @param filterMode Type of filtering to perform.
+   */
+  template<Location L, class IO2>
+  void sample(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, ThetaState<B,L>& s, IO2* inInit = NULL,
+      const int C = 1, const FilterMode filterMode = UNCONDITIONED);
+  //@}
+
+  /**
+   * @name Low-level interface.
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Initialise.
+   *
+   * @tparam L Location.
+   * @tparam IO2 Input type.
+   *
+   * @param rngs Random number generators, one per chain.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param ss States, one per chain.
+   * @param inInit Initialisation file.
+   */
+  template<Location L, class IO2>
+  void init(std::vector<Random*>& rngs, const ScheduleIterator first,
+      const ScheduleIterator last, std::vector<ThetaState<B,L>*>& ss,
+      IO2* inInit = NULL);
+
+  /**
+   * Take one step in each chain.
+   *
+   * @tparam L Location.
+   *
+   * @param rngs Random number generators, one per chain.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] ss States, one per chain.
+   * @param filterMode Type of filtering to perform.
+   *
+   * @return Number of chains in which the step was accepted.
+   */
+  template<Location L>
+  int step(std::vector<Random*>& rngs, const ScheduleIterator first,
+      const ScheduleIterator last, std::vector<ThetaState<B,L>*>& ss,
+      const FilterMode filterMode = UNCONDITIONED);
+
+  /**
+   * Output.
+   *
+   * @tparam L Location.
+   *
+   * @param c Step index.
+   * @param ss States, one per chain.
+   */
+  template<Location L>
+  void output(const int c, std::vector<ThetaState<B,L>*>& ss);
+
+  /**
+   * Report progress on stderr.
+   *
+   * @tparam L Location.
+   *
+   * @param c Step index.
+   * @param ss States, one per chain.
+   */
+  template<Location L>
+  void report(const int c, std::vector<ThetaState<B,L>*>& ss);
+
+  /**
+   * Terminate.
+   */
+  void term();
+  //@}
+
+  /**
+   * @name Diagnostics
+   */
+  //@{
+  /**
+   * Get number of steps taken, across all chains.
+   */
+  int getNumSteps();
+
+  /**
+   * Get number of accepted proposals, across all chains.
+   */
+  int getNumAccepted();
+  //@}
+
+private:
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Chains.
+   */
+  std::vector<chain_type*> chains;
+
+  /**
+   * Output buffer.
+   */
+  IO1* out;
+};
+
+/**
+ * Factory for creating MultiChainParticleMarginalMetropolisHastings
+ * objects.
+ *
+ * @ingroup method
+ *
+ * @see MultiChainParticleMarginalMetropolisHastings
+ */
+struct MultiChainParticleMarginalMetropolisHastingsFactory {
+  /**
+   * Create multi-chain particle MCMC sampler.
+   *
+   * @return MultiChainParticleMarginalMetropolisHastings object. Caller has
+   * ownership.
+   *
+   * @see MultiChainParticleMarginalMetropolisHastings::MultiChainParticleMarginalMetropolisHastings()
+   */
+  template<class B, class F, class IO1>
+  static MultiChainParticleMarginalMetropolisHastings<B,F,IO1>* create(B& m,
+      const std::vector<F*>& filters, IO1* out = NULL) {
+    return new MultiChainParticleMarginalMetropolisHastings<B,F,IO1>(m,
+        filters, out);
+  }
+};
+}
+
+#include "../misc/omp.hpp"
+
+#include <limits>
+
+template<class B, class F, class IO1>
+bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::MultiChainParticleMarginalMetropolisHastings(
+    B& m, const std::vector<F*>& filters, IO1* out) :
+    m(m), chains(filters.size()), out(out) {
+  /* pre-condition */
+  BI_ASSERT(filters.size() > 0);
+
+  for (int n = 0; n < int(chains.size()); ++n) {
+    chains[n] = new chain_type(m, filters[n]);
+  }
+}
+
+template<class B, class F, class IO1>
+bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::~MultiChainParticleMarginalMetropolisHastings() {
+  for (int n = 0; n < int(chains.size()); ++n) {
+    delete chains[n];
+  }
+}
+
+template<class B, class F, class IO1>
+inline int bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::getNumChains() const {
+  return chains.size();
+}
+
+template<class B, class F, class IO1>
+inline typename bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::chain_type*
+    bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::getChain(
+    const int n) {
+  /* pre-condition */
+  BI_ASSERT(n >= 0 && n < int(chains.size()));
+
+  return chains[n];
+}
+
+template<class B, class F, class IO1>
+IO1* bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::getOutput() {
+  return out;
+}
+
+template<class B, class F, class IO1>
+void bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::setOutput(
+    IO1* out) {
+  this->out = out;
+}
+
+template<class B, class F, class IO1>
+template<bi::Location L, class IO2>
+void bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::sample(
+    Random& rng, const ScheduleIterator first, const ScheduleIterator last,
+    ThetaState<B,L>& s, IO2* inInit, const int C,
+    const FilterMode filterMode) {
+  /* pre-condition */
+  BI_ASSERT(C >= 0);
+
+  const int N = chains.size();
+  const int P = s.size();
+  const int T = s.getTrajectory().size2();
+
+  std::vector<ThetaState<B,L>*> ss(N);
+  std::vector<Random*> rngs(N);
+  int n, c;
+
+  /* seed each chain's generators from a single draw, so that results are
+   * reproducible for a given seed and number of threads */
+  const int seed = rng.uniformInt<int>(0,
+      std::numeric_limits<int>::max() / ((N + 1)*bi_omp_max_threads));
+  for (n = 0; n < N; ++n) {
+    ss[n] = new ThetaState<B,L>(P, T);
+    *ss[n] = s;
+    rngs[n] = new Random(seed + n);
+  }
+
+  init(rngs, first, last, ss, inInit);
+  for (c = 0; c < C; ++c) {
+    step(rngs, first, last, ss, filterMode);
+    report(c, ss);
+    output(c, ss);
+    for (n = 0; n < N; ++n) {
+      ss[n]->setRange(0, P);
+    }
+  }
+  term();
+
+  for (n = 0; n < N; ++n) {
+    delete rngs[n];
+    delete ss[n];
+  }
+}
+
+template<class B, class F, class IO1>
+template<bi::Location L, class IO2>
+void bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::init(
+    std::vector<Random*>& rngs, const ScheduleIterator first,
+    const ScheduleIterator last, std::vector<ThetaState<B,L>*>& ss,
+    IO2* inInit) {
+  /* pre-conditions */
+  BI_ASSERT(rngs.size() == chains.size());
+  BI_ASSERT(ss.size() == chains.size());
+
+  const int N = chains.size();
+  int n;
+
+  /* first chain alone, warming the shared input and observation caches */
+  chains[0]->init(*rngs[0], first, last, *ss[0], inInit);
+
+  #pragma omp parallel for schedule(static) if (L == ON_HOST)
+  for (n = 1; n < N; ++n) {
+    omp_set_num_threads(1);
+    chains[n]->init(*rngs[n], first, last, *ss[n], inInit);
+  }
+
+  if (out != NULL) {
+    out->clear();
+  }
+}
+
+template<class B, class F, class IO1>
+template<bi::Location L>
+int bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::step(
+    std::vector<Random*>& rngs, const ScheduleIterator first,
+    const ScheduleIterator last, std::vector<ThetaState<B,L>*>& ss,
+    const FilterMode filterMode) {
+  /* pre-conditions */
+  BI_ASSERT(rngs.size() == chains.size());
+  BI_ASSERT(ss.size() == chains.size());
+
+  const int N = chains.size();
+  int n, naccept = 0;
+
+  #pragma omp parallel for schedule(static) reduction(+:naccept) if (L == ON_HOST)
+  for (n = 0; n < N; ++n) {
+    omp_set_num_threads(1);
+    if (chains[n]->step(*rngs[n], first, last, *ss[n], filterMode)) {
+      ++naccept;
+    }
+  }
+  return naccept;
+}
+
+template<class B, class F, class IO1>
+template<bi::Location L>
+void bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::output(
+    const int c, std::vector<ThetaState<B,L>*>& ss) {
+  const int N = chains.size();
+  int n, p;
+
+  if (out != NULL) {
+    if (c == 0) {
+      out->writeTimes(0, chains[0]->getFilter()->getOutput()->getTimes());
+    }
+    for (n = 0; n < N; ++n) {
+      p = c*N + n;
+      out->writeLogLikelihood(p, ss[n]->getLogLikelihood1());
+      out->writeLogPrior(p, ss[n]->getLogPrior1());
+      out->writeParameter(p, ss[n]->getParameters1());
+      out->writeTrajectory(p, ss[n]->getTrajectory());
+      if (out->isFull()) {
+        out->flushAsync();
+      }
+    }
+  }
+}
+
+template<class B, class F, class IO1>
+template<bi::Location L>
+void bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::report(
+    const int c, std::vector<ThetaState<B,L>*>& ss) {
+  const int N = chains.size();
+
+  std::cerr << c << ":";
+  for (int n = 0; n < N; ++n) {
+    std::cerr << '\t';
+    std::cerr.width(10);
+    std::cerr << ss[n]->getLogLikelihood1();
+    if (chains[n]->wasLastAccepted()) {
+      std::cerr << '*';
+    }
+  }
+  std::cerr << "\taccept=" << (double)getNumAccepted() / getNumSteps();
+  std::cerr << std::endl;
+}
+
+template<class B, class F, class IO1>
+void bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::term() {
+  for (int n = 0; n < int(chains.size()); ++n) {
+    chains[n]->term();
+  }
+}
+
+template<class B, class F, class IO1>
+int bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::getNumSteps() {
+  int total = 0;
+  for (int n = 0; n < int(chains.size()); ++n) {
+    total += chains[n]->getNumSteps();
+  }
+  return total;
+}
+
+template<class B, class F, class IO1>
+int bi::MultiChainParticleMarginalMetropolisHastings<B,F,IO1>::getNumAccepted() {
+  int accepted = 0;
+  for (int n = 0; n < int(chains.size()); ++n) {
+    accepted += chains[n]->getNumAccepted();
+  }
+  return accepted;
+}
+
+#endif
@@ -10,8 +10,11 @@
 
 #include "../state/Mask.hpp"
 #include "../buffer/SparseInputNetCDFBuffer.hpp"
+#include "../buffer/SparseInputStore.hpp"
 #include "../cache/Cache2D.hpp"
 #include "../cache/CacheObject.hpp"
+#include "../state/ScheduleIterator.hpp"
+#include "../misc/BackgroundThread.hpp"
 
 namespace bi {
 /**
@@ -21,6 +24,10 @@ namespace bi {
  *
  * @tparam IO1 Input type.
  * @tparam CL Location for caches.
+ *
+ * As for Forcer, observations and masks are read on first use by default,
+ * or may be read at once with preload(), or ahead of their use with
+ * prefetch(), or read from a SparseInputStore with setStore().
  */
 template<class IO1 = SparseInputNetCDFBuffer, Location CL = ON_HOST>
 class Observer {
@@ -32,6 +39,28 @@ public:
    */
   Observer(IO1* in);
 
+  /**
+   * Destructor.
+   */
+  ~Observer();
+
+  /**
+   * Get store.
+   */
+  SparseInputStore* getStore();
+
+  /**
+   * Set store.
+   *
+   * @param store Store from which to read observations and masks in place
+   * of @c in, or NULL to read from @c in. Caller retains ownership.
+   *
+   * Observations and masks on host are then read from the store directly,
+   * and not cached. Masks on device are still copied from the store once
+   * and cached.
+   */
+  void setStore(SparseInputStore* store);
+
   /**
    * Get mask on host.
    *
@@ -62,12 +91,94 @@ public:
   template<class B, Location L>
   void update(const int k, State<B,L>& s);
 
+  /**
+   * Read all observations and masks of a time schedule into the cache.
+   *
+   * @tparam B Model type.
+   * @tparam L Location.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State, used as workspace. Its observations are
+   * overwritten.
+   *
+   * Does nothing if a store is set.
+   */
+  template<class B, Location L>
+  void preload(const ScheduleIterator first, const ScheduleIterator last,
+      State<B,L>& s);
+
+  /**
+   * Read the observations and masks of a time schedule into the cache in
+   * the background.
+   *
+   * @tparam B Model type.
+   * @tparam L Location.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State, used as workspace. Its observations are
+   * overwritten.
+   * @param lookahead Number of observation times to read at once.
+   * @param thread Thread on which to read.
+   *
+   * Does nothing if a store is set.
+   *
+   * @see Forcer::prefetch()
+   */
+  template<class B, Location L>
+  void prefetch(const ScheduleIterator first, const ScheduleIterator last,
+      State<B,L>& s, const int lookahead, BackgroundThread* thread);
+
 private:
+  /**
+   * Job to read a window of observations and masks.
+   */
+  class PrefetchJob: public BackgroundJob {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param obs Owner.
+     * @param N Size of observations.
+     */
+    PrefetchJob(Observer<IO1,CL>* obs, const int N);
+
+    virtual void run();
+
+    /**
+     * Owner.
+     */
+    Observer<IO1,CL>* obs;
+
+    /**
+     * Workspace.
+     */
+    host_matrix<real> X;
+
+    /**
+     * Window, as a range of #ks.
+     */
+    int start, end;
+  };
+
+  /**
+   * Wait for prefetching of time index, if necessary.
+   *
+   * @param k Time index.
+   */
+  void fetch(const int k);
+
   /**
    * Input.
    */
   IO1* in;
 
+  /**
+   * Store, NULL if none.
+   */
+  SparseInputStore* store;
+
   /**
    * Cache.
    */
@@ -82,6 +193,36 @@ private:
    * Cache for masks.
    */
   CacheObject<Mask<CL> > maskCache;
+
+  /**
+   * Prefetch thread, NULL if not prefetching.
+   */
+  BackgroundThread* thread;
+
+  /**
+   * Prefetch job.
+   */
+  PrefetchJob* job;
+
+  /**
+   * Time indices to prefetch, in order of use.
+   */
+  std::vector<int> ks;
+
+  /**
+   * Number of time indices in #ks that are in the cache.
+   */
+  int ready;
+
+  /**
+   * Number of time indices in #ks that are in the cache or being read.
+   */
+  int pending;
+
+  /**
+   * Number of time indices to read at once.
+   */
+  int lookahead;
 };
 
 /**
@@ -112,13 +253,36 @@ struct ObserverFactory {
 }
 
 template<class IO1, bi::Location CL>
-bi::Observer<IO1,CL>::Observer(IO1* in) : in(in) {
+bi::Observer<IO1,CL>::Observer(IO1* in) : in(in), store(NULL),
+    thread(NULL), job(NULL), ready(0), pending(0), lookahead(0) {
   //
 }
 
+template<class IO1, bi::Location CL>
+bi::Observer<IO1,CL>::~Observer() {
+  delete job;
+}
+
+template<class IO1, bi::Location CL>
+inline bi::SparseInputStore* bi::Observer<IO1,CL>::getStore() {
+  return store;
+}
+
+template<class IO1, bi::Location CL>
+inline void bi::Observer<IO1,CL>::setStore(SparseInputStore* store) {
+  this->store = store;
+}
+
 template<class IO1, bi::Location CL>
 const bi::Mask<bi::ON_HOST>& bi::Observer<IO1,CL>::getHostMask(const int k) {
+  if (store != NULL) {
+    return store->getMask(k, O_VAR);
+  }
+  fetch(k);
   if (!maskHostCache.isValid(k)) {
+    if (thread != NULL) {
+      thread->wait();
+    }
     Mask<ON_HOST> mask;
     in->readMask(k, O_VAR, mask);
     maskHostCache.set(k, mask);
@@ -128,6 +292,10 @@ const bi::Mask<bi::ON_HOST>& bi::Observer<IO1,CL>::getHostMask(const int k) {
 
 template<class IO1, bi::Location CL>
 const bi::Mask<CL>& bi::Observer<IO1,CL>::getMask(const int k) {
+  if (store != NULL && CL == ON_HOST) {
+    /* same type, cast only so that this compiles for CL == ON_DEVICE */
+    return reinterpret_cast<const Mask<CL>&>(store->getMask(k, O_VAR));
+  }
   if (!maskCache.isValid(k)) {
     maskCache.set(k, getHostMask(k));
   }
@@ -137,12 +305,116 @@ const bi::Mask<CL>& bi::Observer<IO1,CL>::getMask(const int k) {
 template<class IO1, bi::Location CL>
 template<class B, bi::Location L>
 inline void bi::Observer<IO1,CL>::update(const int k, State<B,L>& s) {
-  if (cache.isValid(k)) {
+  fetch(k);
+  if (store != NULL) {
+    store->read(k, O_VAR, s.get(OY_VAR));
+  } else if (cache.isValid(k)) {
     vec(s.get(OY_VAR)) = cache.get(k);
   } else {
+    if (thread != NULL) {
+      thread->wait();
+    }
     in->readState(k, O_VAR, getHostMask(k), s.get(OY_VAR));
     cache.set(k, vec(s.get(OY_VAR)));
   }
 }
 
+template<class IO1, bi::Location CL>
+template<class B, bi::Location L>
+void bi::Observer<IO1,CL>::preload(const ScheduleIterator first,
+    const ScheduleIterator last, State<B,L>& s) {
+  ScheduleIterator iter;
+
+  if (store != NULL) {
+    return;
+  }
+  for (iter = first; iter != last; ++iter) {
+    if (iter->hasObs()) {
+      getMask(iter->indexObs());
+      update(iter->indexObs(), s);
+    }
+  }
+}
+
+template<class IO1, bi::Location CL>
+template<class B, bi::Location L>
+void bi::Observer<IO1,CL>::prefetch(const ScheduleIterator first,
+    const ScheduleIterator last, State<B,L>& s, const int lookahead,
+    BackgroundThread* thread) {
+  /* pre-conditions */
+  BI_ASSERT(lookahead > 0);
+  BI_ASSERT(thread != NULL);
+  BI_ASSERT(this->thread == NULL);
+
+#ifdef ENABLE_CUDA
+  preload(first, last, s);
+#else
+  if (CL == ON_DEVICE || store != NULL) {
+    preload(first, last, s);
+  } else {
+    ScheduleIterator iter;
+    for (iter = first; iter != last; ++iter) {
+      if (iter->hasObs() && (ks.empty() || iter->indexObs() != ks.back())) {
+        ks.push_back(iter->indexObs());
+      }
+    }
+  }
+  if (!ks.empty()) {
+    const int N = s.get(OY_VAR).size1()*s.get(OY_VAR).size2();
+
+    /* size the caches up front, so that the thread never reallocates them */
+    const int K = in->getTimes().size();
+    if (cache.size() < K) {
+      cache.resize(N, K);
+    }
+    if (maskHostCache.size() < K) {
+      maskHostCache.resize(K);
+    }
+
+    this->thread = thread;
+    this->lookahead = lookahead;
+    job = new PrefetchJob(this, N);
+    ready = 0;
+    pending = bi::min(lookahead, (int)ks.size());
+    job->start = ready;
+    job->end = pending;
+    thread->submit(job);
+  }
+#endif
+}
+
+template<class IO1, bi::Location CL>
+void bi::Observer<IO1,CL>::fetch(const int k) {
+  while (ready < (int)ks.size() && k >= ks[ready]) {
+    /* reached the window being read, wait for it and start on the next */
+    thread->wait();
+    ready = pending;
+    if (pending < (int)ks.size()) {
+      pending = bi::min(pending + lookahead, (int)ks.size());
+      job->start = ready;
+      job->end = pending;
+      thread->submit(job);
+    }
+  }
+}
+
+template<class IO1, bi::Location CL>
+bi::Observer<IO1,CL>::PrefetchJob::PrefetchJob(Observer<IO1,CL>* obs,
+    const int N) : obs(obs), X(1, N), start(0), end(0) {
+  //
+}
+
+template<class IO1, bi::Location CL>
+void bi::Observer<IO1,CL>::PrefetchJob::run() {
+  int i, k;
+  for (i = start; i < end; ++i) {
+    k = obs->ks[i];
+    Mask<ON_HOST> mask;
+    obs->in->readMask(k, O_VAR, mask);
+    obs->maskHostCache.set(k, mask);
+    obs->in->readState(k, O_VAR, obs->maskHostCache.get(k), X);
+    obs->cache.set(k, row(X, 0));
+  }
+}
+
 #endif
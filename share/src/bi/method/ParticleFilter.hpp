@@ -10,6 +10,7 @@
 
 #include "Simulator.hpp"
 #include "../cache/ParticleFilterCache.hpp"
+#include "../resampler/WeightStats.hpp"
 
 namespace bi {
 /**
@@ -151,7 +152,8 @@ public:
    * @param[in,out] rng Random number generator.
    * @param[out] X Trajectory.
    *
-   * Sample a single particle trajectory from the smooth distribution.
+   * Sample a single particle trajectory from the smooth distribution. It is
+   * traced back with AncestryCache::readTrajectories().
    *
    * On output, @p X is arranged such that rows index variables and columns
    * index times.
@@ -227,6 +229,17 @@ public:
   real step(Random& rng, ScheduleIterator& iter, const ScheduleIterator last,
       State<B,L>& s, V1 lws, V2 as);
 
+  /**
+   * Resample, predict and correct, with cached weight statistics.
+   *
+   * @param[in,out] ws Statistics of @p lws, kept current on return.
+   *
+   * @see step(Random&, ScheduleIterator&, const ScheduleIterator, State<B,L>&, V1, V2)
+   */
+  template<bi::Location L, class V1, class V2>
+  real step(Random& rng, ScheduleIterator& iter, const ScheduleIterator last,
+      State<B,L>& s, V1 lws, V2 as, WeightStats& ws);
+
   /**
    * Resample, predict and correct, conditionally.
    *
@@ -251,6 +264,18 @@ public:
   real step(Random& rng, ScheduleIterator& iter, const ScheduleIterator last,
       State<B,L>& s, const M1 X, V1 lws, V2 as);
 
+  /**
+   * Resample, predict and correct, conditionally, with cached weight
+   * statistics.
+   *
+   * @param[in,out] ws Statistics of @p lws, kept current on return.
+   *
+   * @see step(Random&, ScheduleIterator&, const ScheduleIterator, State<B,L>&, const M1, V1, V2)
+   */
+  template<bi::Location L, class M1, class V1, class V2>
+  real step(Random& rng, ScheduleIterator& iter, const ScheduleIterator last,
+      State<B,L>& s, const M1 X, V1 lws, V2 as, WeightStats& ws);
+
   /**
    * Predict.
    *
@@ -278,6 +303,26 @@ public:
   template<Location L, class V1>
   real correct(const ScheduleElement now, State<B,L>& s, V1 lws);
 
+  /**
+   * Update particle weights using observations at the current time, with
+   * cached weight statistics.
+   *
+   * @tparam L Location.
+   * @tparam V1 Vector type.
+   *
+   * @param now Current step in time schedule.
+   * @param s State.
+   * @param lws Log-weights.
+   * @param[in,out] ws Statistics of @p lws. If there are observations, these
+   * are recomputed in the same pass as the log-weights, and the incremental
+   * log-likelihood taken from them.
+   *
+   * @return Estimate of the incremental log-likelihood.
+   */
+  template<Location L, class V1>
+  real correct(const ScheduleElement now, State<B,L>& s, V1 lws,
+      WeightStats& ws);
+
   /**
    * Resample.
    *
@@ -297,6 +342,18 @@ public:
   bool resample(Random& rng, const ScheduleElement now, State<B,L>& s, V1 lws,
       V2 as);
 
+  /**
+   * Resample, with cached weight statistics.
+   *
+   * @param[in,out] ws Statistics of @p lws. Used to decide whether to
+   * resample, and kept current on return.
+   *
+   * @see resample(Random&, const ScheduleElement, State<B,L>&, V1, V2)
+   */
+  template<Location L, class V1, class V2>
+  bool resample(Random& rng, const ScheduleElement now, State<B,L>& s, V1 lws,
+      V2 as, WeightStats& ws);
+
   /**
    * Resample with conditioned outcome for first particle.
    *
@@ -416,6 +473,8 @@ struct ParticleFilterFactory {
 };
 }
 
+#include "../math/loc_temp_matrix.hpp"
+#include "../math/temp_vector.hpp"
 #include "../primitive/vector_primitive.hpp"
 #include "../primitive/matrix_primitive.hpp"
 #include "../traits/resampler_traits.hpp"
@@ -471,14 +530,15 @@ real bi::ParticleFilter<B,S,R,IO1>::filter(Random& rng,
 
   typename loc_temp_vector<L,real>::type lws(P);
   typename loc_temp_vector<L,int>::type as(P);
+  WeightStats ws;
 
   ScheduleIterator iter = first;
   init(rng, *iter, s, lws, as, inInit);
   output0(s);
-  ll = correct(*iter, s, lws);
+  ll = correct(*iter, s, lws, ws);
   output(*iter, s, r, lws, as);
   while (iter + 1 != last) {
-    ll += step(rng, iter, last, s, lws, as);
+    ll += step(rng, iter, last, s, lws, as, ws);
   }
   term();
   outputT(ll);
@@ -500,14 +560,15 @@ real bi::ParticleFilter<B,S,R,IO1>::filter(Random& rng,
 
   typename loc_temp_vector<L,real>::type lws(P);
   typename loc_temp_vector<L,int>::type as(P);
+  WeightStats ws;
 
   ScheduleIterator iter = first;
   init(rng, theta, *iter, s, lws, as);
   output0(s);
-  ll = correct(*iter, s, lws);
+  ll = correct(*iter, s, lws, ws);
   output(*iter, s, r, lws, as);
   while (iter + 1 != last) {
-    ll += step(rng, iter, last, s, lws, as);
+    ll += step(rng, iter, last, s, lws, as, ws);
   }
   term();
   outputT(ll);
@@ -529,15 +590,16 @@ real bi::ParticleFilter<B,S,R,IO1>::filter(Random& rng,
 
   typename loc_temp_vector<L,real>::type lws(P);
   typename loc_temp_vector<L,int>::type as(P);
+  WeightStats ws;
 
   ScheduleIterator iter = first;
   init(rng, theta, *iter, s, lws, as);
   row(s.getDyn(), 0) = column(X, 0);
   output0(s);
-  ll = correct(*iter, s, lws);
+  ll = correct(*iter, s, lws, ws);
   output(*iter, s, r, lws, as);
   while (iter + 1 != last) {
-    ll += step(rng, iter, last, s, X, lws, as);
+    ll += step(rng, iter, last, s, X, lws, as, ws);
   }
   term();
   outputT(ll);
@@ -551,9 +613,9 @@ void bi::ParticleFilter<B,S,R,IO1>::sampleTrajectory(Random& rng, M1 X) {
   /* pre-condition */
   BI_ASSERT(out != NULL);
 
-  /* pre-condition */
-  int p = rng.multinomial(out->getLogWeights());
-  out->readTrajectory(p, X);
+  typename temp_host_vector<int>::type ps(1);
+  ps(0) = rng.multinomial(out->getLogWeights());
+  out->readTrajectories(ps, X);
 }
 
 template<class B, class S, class R, class IO1>
@@ -592,12 +654,70 @@ template<class B, class S, class R, class IO1>
 template<bi::Location L, class V1, class V2>
 real bi::ParticleFilter<B,S,R,IO1>::step(Random& rng, ScheduleIterator& iter,
     const ScheduleIterator last, State<B,L>& s, V1 lws, V2 as) {
-  bool r = resample(rng, *iter, s, lws, as);
-  do {
-    ++iter;
-    predict(rng, *iter, s);
-  } while (iter + 1 != last && !iter->hasOutput());
-  real ll = correct(*iter, s, lws);
+  WeightStats ws;
+  return step(rng, iter, last, s, lws, as, ws);
+}
+
+template<class B, class S, class R, class IO1>
+template<bi::Location L, class V1, class V2>
+real bi::ParticleFilter<B,S,R,IO1>::step(Random& rng, ScheduleIterator& iter,
+    const ScheduleIterator last, State<B,L>& s, V1 lws, V2 as,
+    WeightStats& ws) {
+  bool r = resample(rng, *iter, s, lws, as, ws);
+  const int p = s.start(), P = s.size();
+  int K = P;
+  if (r) {
+    /* ready particles, in ranges aligned as State::setRange() requires */
+    K = resam->numReady(P);
+    while (K > 0 && (s.roundup(K) != K || s.roundup(P - K) != P - K)) {
+      --K;
+    }
+    if (K == 0) {
+      resam->finish(as, s);
+      K = P;
+    }
+  }
+
+  if (K == P) {
+    do {
+      ++iter;
+      predict(rng, *iter, s);
+    } while (iter + 1 != last && !iter->hasOutput());
+  } else {
+    typedef typename loc_temp_matrix<L,real>::type matrix_type;
+
+    ScheduleIterator iter1 = iter;
+    int j, n = 0;
+    do {
+      ++iter1;
+      ++n;
+    } while (iter1 + 1 != last && !iter1->hasOutput());
+    matrix_type Fs(n, s.get(F_VAR).size2());
+
+    /* propagate particles that are ready, while any others are in transit,
+     * keeping the inputs of each schedule element */
+    iter1 = iter;
+    s.setRange(p, K);
+    for (j = 0; j < n; ++j) {
+      ++iter;
+      predict(rng, *iter, s);
+      row(Fs, j) = row(s.get(F_VAR), 0);
+    }
+    s.setRange(p, P);
+    resam->finish(as, s);
+
+    /* propagate the remainder once they have arrived, restoring rather than
+     * updating inputs, which ends with those of the last element as
+     * before */
+    s.setRange(p + K, P - K);
+    for (j = 0; j < n; ++j) {
+      ++iter1;
+      row(s.get(F_VAR), 0) = row(Fs, j);
+      sim->transition(rng, *iter1, s);
+    }
+    s.setRange(p, P);
+  }
+  real ll = correct(*iter, s, lws, ws);
   output(*iter, s, r, lws, as);
 
   return ll;
@@ -607,13 +727,25 @@ template<class B, class S, class R, class IO1>
 template<bi::Location L, class M1, class V1, class V2>
 real bi::ParticleFilter<B,S,R,IO1>::step(Random& rng, ScheduleIterator& iter,
     const ScheduleIterator last, State<B,L>& s, const M1 X, V1 lws, V2 as) {
-  bool r = resample(rng, *iter, s, lws, as);
+  WeightStats ws;
+  return step(rng, iter, last, s, X, lws, as, ws);
+}
+
+template<class B, class S, class R, class IO1>
+template<bi::Location L, class M1, class V1, class V2>
+real bi::ParticleFilter<B,S,R,IO1>::step(Random& rng, ScheduleIterator& iter,
+    const ScheduleIterator last, State<B,L>& s, const M1 X, V1 lws, V2 as,
+    WeightStats& ws) {
+  bool r = resample(rng, *iter, s, lws, as, ws);
+  if (r) {
+    resam->finish(as, s);
+  }
   do {
     ++iter;
     predict(rng, *iter, s);
   } while (iter + 1 != last && !iter->hasOutput());
   row(s.getDyn(), 0) = column(X, iter->indexOutput());
-  real ll = correct(*iter, s, lws);
+  real ll = correct(*iter, s, lws, ws);
   output(*iter, s, r, lws, as);
 
   return ll;
@@ -630,13 +762,23 @@ template<class B, class S, class R, class IO1>
 template<bi::Location L, class V1>
 real bi::ParticleFilter<B,S,R,IO1>::correct(const ScheduleElement now,
     State<B,L>& s, V1 lws) {
+  WeightStats ws;
+  return correct(now, s, lws, ws);
+}
+
+template<class B, class S, class R, class IO1>
+template<bi::Location L, class V1>
+real bi::ParticleFilter<B,S,R,IO1>::correct(const ScheduleElement now,
+    State<B,L>& s, V1 lws, WeightStats& ws) {
   /* pre-condition */
   BI_ASSERT(s.size() == lws.size());
 
   real ll = 0.0;
   if (now.hasObs()) {
-    m.observationLogDensities(s, sim->getObs()->getMask(now.indexObs()), lws);
-    ll = logsumexp_reduce(lws) - bi::log(static_cast<real>(s.size()));
+    /* log-densities and their statistics in a single pass */
+    ws = m.observationLogSumExpDensities(s,
+        sim->getObs()->getMask(now.indexObs()), lws);
+    ll = ws.logSumExp() - bi::log(static_cast<real>(s.size()));
   }
   return ll;
 }
@@ -645,10 +787,19 @@ template<class B, class S, class R, class IO1>
 template<bi::Location L, class V1, class V2>
 bool bi::ParticleFilter<B,S,R,IO1>::resample(Random& rng,
     const ScheduleElement now, State<B,L>& s, V1 lws, V2 as) {
+  WeightStats ws;
+  return resample(rng, now, s, lws, as, ws);
+}
+
+template<class B, class S, class R, class IO1>
+template<bi::Location L, class V1, class V2>
+bool bi::ParticleFilter<B,S,R,IO1>::resample(Random& rng,
+    const ScheduleElement now, State<B,L>& s, V1 lws, V2 as,
+    WeightStats& ws) {
   /* pre-condition */
   BI_ASSERT(s.size() == lws.size());
 
-  bool r = now.hasObs() && resam != NULL && resam->isTriggered(lws);
+  bool r = now.hasObs() && resam != NULL && resam->isTriggered(lws, ws);
   if (r) {
     if (resampler_needs_max<R>::value) {
       resam->setMaxLogWeight(
@@ -656,9 +807,10 @@ bool bi::ParticleFilter<B,S,R,IO1>::resample(Random& rng,
               sim->getObs()->getMask(now.indexObs())));
     }
     resam->resample(rng, lws, as, s);
+    ws.invalidate();
   } else {
     seq_elements(as, 0);
-    Resampler::normalise(lws);
+    Resampler::normalise(lws, ws);
   }
   return r;
 }
@@ -679,6 +831,7 @@ bool bi::ParticleFilter<B,S,R,IO1>::resample(Random& rng,
               sim->getObs()->getMask(now.indexObs())));
     }
     resam->cond_resample(rng, a, a, lws, as, s);
+    resam->finish(as, s);
   } else {
     seq_elements(as, 0);
     Resampler::normalise(lws);
@@ -705,8 +705,7 @@ void bi::ParticleMarginalMetropolisHastings<B,F,IO1>::output(const int c,
     out->writeParameter(c, s.getParameters1());
     out->writeTrajectory(c, s.getTrajectory());
     if (out->isFull()) {
-      out->flush();
-      out->clear();
+      out->flushAsync();
     }
   }
 }
@@ -22,6 +22,8 @@
 #include "../pdf/misc.hpp"
 #include "../pdf/GaussianPdf.hpp"
 
+#include <vector>
+
 namespace bi {
 /**
  * Sequential Monte Carlo squared (SMC^2).
@@ -85,6 +87,25 @@ public:
    */
   void setOutput(IO1* out);
 
+  /**
+   * Set samplers for parallel rejuvenation and stepping.
+   *
+   * @param movers PMMH samplers, one per host thread. Each must have its own
+   * filter, and that filter its own resampler, but all may share the one
+   * simulator. If none are given, rejuvenation and stepping use the sampler
+   * given to the constructor, and the random number generator given to
+   * sample().
+   *
+   * When rejuvenating in parallel, each \f$\theta\f$-particle is moved
+   * single-threaded, with a random number generator seeded from @c rng and
+   * the index of that \f$\theta\f$-particle. Moves are then reproducible for
+   * a given seed, regardless of the number of threads or the order in which
+   * \f$\theta\f$-particles are moved. The \f$x\f$-particles of all
+   * \f$\theta\f$-particles are stepped forward in the same way, within a
+   * single parallel region per step.
+   */
+  void setMovers(const std::vector<F*>& movers);
+
   /**
    * Sample.
    *
@@ -154,6 +175,35 @@ public:
       const ScheduleIterator last, ThetaParticle<B,L>& s,
       std::vector<ThetaParticle<B,L>*>& thetas, V1 lws, V2 as);
 
+  /**
+   * Step \f$x\f$-particles of all \f$\theta\f$-particles forward.
+   *
+   * @tparam L Location.
+   * @tparam V1 Vector type
+   *
+   * @param[in,out] rng Random number generator.
+   * @param[in,out] iter Current position in time schedule. Advanced on
+   * return.
+   * @param last End of time schedule.
+   * @param[in,out] thetas The \f$\theta\f$-particles.
+   * @param[in,out] lws Log-weights of \f$\theta\f$-particles.
+   */
+  template<Location L, class V1>
+  void stepX(Random& rng, ScheduleIterator& iter,
+      const ScheduleIterator last, std::vector<ThetaParticle<B,L>*>& thetas,
+      V1 lws);
+
+  /**
+   * Step \f$x\f$-particles of all \f$\theta\f$-particles forward, in
+   * parallel.
+   *
+   * @see stepX(), setMovers()
+   */
+  template<Location L, class V1>
+  void stepXParallel(Random& rng, ScheduleIterator& iter,
+      const ScheduleIterator last, std::vector<ThetaParticle<B,L>*>& thetas,
+      V1 lws);
+
   /**
    * Adapt proposal distribution.
    *
@@ -206,6 +256,31 @@ public:
       const ScheduleIterator now, ThetaParticle<B,L>& s,
       const std::vector<ThetaParticle<B,L>*>& thetas, GaussianPdf<V1,M1>& q);
 
+  /**
+   * Rejuvenate \f$\theta\f$-particles in parallel.
+   *
+   * @see rejuvenate(), setMovers()
+   */
+  template<Location L, class V1, class M1>
+  real rejuvenateParallel(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator now, ThetaParticle<B,L>& s,
+      const std::vector<ThetaParticle<B,L>*>& thetas, GaussianPdf<V1,M1>& q);
+
+  /**
+   * Keep the state of an accepted move.
+   *
+   * @tparam L Location.
+   *
+   * @param[out] theta \f$\theta\f$-particle.
+   * @param[in,out] s Working state, just accepted.
+   *
+   * The buffers of @p s are swapped into @p theta, rather than copied. Only
+   * the current parameters and their log-densities are restored to @p s,
+   * which is all that is required of it for any subsequent move.
+   */
+  template<Location L>
+  void keep(ThetaParticle<B,L>& theta, ThetaParticle<B,L>& s);
+
   /**
    * Output.
    *
@@ -246,6 +321,11 @@ private:
    */
   F* pmmh;
 
+  /**
+   * PMCMC samplers for parallel rejuvenation, one per thread.
+   */
+  std::vector<F*> movers;
+
   /**
    * Resampler for the theta-particles
    */
@@ -307,8 +387,12 @@ struct SMC2Factory {
 #include "../math/sim_temp_vector.hpp"
 #include "../math/sim_temp_matrix.hpp"
 
+#include "../misc/omp.hpp"
+
 #include "boost/typeof/typeof.hpp"
 
+#include <limits>
+
 template<class B, class F, class R, class IO1>
 bi::SMC2<B,F,R,IO1>::SMC2(B& m, F* pmmh, R* resam, const int Nmoves,
     const SMC2Adapter adapter, const real adapterScale, IO1* out) :
@@ -317,6 +401,14 @@ bi::SMC2<B,F,R,IO1>::SMC2(B& m, F* pmmh, R* resam, const int Nmoves,
   //
 }
 
+template<class B, class F, class R, class IO1>
+void bi::SMC2<B,F,R,IO1>::setMovers(const std::vector<F*>& movers) {
+  /* pre-condition */
+  BI_ASSERT(int(movers.size()) <= bi_omp_max_threads);
+
+  this->movers = movers;
+}
+
 template<class B, class F, class R, class IO1>
 template<bi::Location L, class IO2>
 void bi::SMC2<B,F,R,IO1>::sample(Random& rng, const ScheduleIterator first,
@@ -412,7 +504,29 @@ real bi::SMC2<B,F,R,IO1>::step(Random& rng, const ScheduleIterator first,
   }
   report(*iter, ess, r, acceptRate);
 
+  if (L == ON_HOST && !movers.empty()) {
+    stepXParallel(rng, iter, last, thetas, lws);
+  } else {
+    stepX(rng, iter, last, thetas, lws);
+  }
+
+  /* compute evidence */
+  for (i = 0; i < thetas.size(); i++) {
+    evidence += bi::exp(lws(i) + thetas[i]->getIncLogLikelihood());
+  }
+  evidence /= sumexp_reduce(lws);
+
+  return evidence;
+}
+
+template<class B, class F, class R, class IO1>
+template<bi::Location L, class V1>
+void bi::SMC2<B,F,R,IO1>::stepX(Random& rng, ScheduleIterator& iter,
+    const ScheduleIterator last, std::vector<ThetaParticle<B,L>*>& thetas,
+    V1 lws) {
   ScheduleIterator iter1;
+  int i;
+
   for (i = 0; i < thetas.size(); i++) {
     BOOST_AUTO(&theta, *thetas[i]);
     BOOST_AUTO(filter, pmmh->getFilter());
@@ -425,14 +539,68 @@ real bi::SMC2<B,F,R,IO1>::step(Random& rng, const ScheduleIterator first,
     lws(i) += theta.getIncLogLikelihood();
 
     filter->sampleTrajectory(rng, theta.getTrajectory());
-
-    /* compute evidence along the way */
-    evidence += bi::exp(lws(i) + theta.getIncLogLikelihood());
   }
-  evidence /= sumexp_reduce(lws);
   iter = iter1;
+}
 
-  return evidence;
+template<class B, class F, class R, class IO1>
+template<bi::Location L, class V1>
+void bi::SMC2<B,F,R,IO1>::stepXParallel(Random& rng, ScheduleIterator& iter,
+    const ScheduleIterator last, std::vector<ThetaParticle<B,L>*>& thetas,
+    V1 lws) {
+  const int P = thetas.size();
+  const int N = movers.size();
+  const int seed = rng.uniformInt<int>(0,
+      std::numeric_limits<int>::max() - P);
+  ScheduleIterator iter1 = iter;
+
+  #pragma omp parallel num_threads(N)
+  {
+    /* each theta-particle is stepped single-threaded, so that there is one
+     * parallel region per step, not one per theta-particle */
+    omp_set_num_threads(1);
+
+    F* mover = movers[bi_omp_tid];
+    BOOST_AUTO(filter, mover->getFilter());
+    Random rng1;
+    ScheduleIterator iter2;
+    int i;
+
+    /* the first theta-particle is stepped alone, so that inputs and
+     * observations over the step are read and cached before being accessed
+     * concurrently */
+    #pragma omp master
+    {
+      iter2 = iter;
+      rng1.seed(seed);
+      filter->setOutput(&thetas[0]->getOutput());
+      thetas[0]->getIncLogLikelihood() = filter->step(rng1, iter2, last,
+          *thetas[0], thetas[0]->getLogWeights(),
+          thetas[0]->getAncestors());
+      filter->sampleTrajectory(rng1, thetas[0]->getTrajectory());
+      iter1 = iter2;
+    }
+    #pragma omp barrier
+
+    /* as each theta-particle has its own seed, dynamic scheduling does not
+     * compromise reproducibility */
+    #pragma omp for schedule(dynamic)
+    for (i = 1; i < P; ++i) {
+      BOOST_AUTO(&theta, *thetas[i]);
+      iter2 = iter;
+      rng1.seed(seed + i);
+      filter->setOutput(&theta.getOutput());
+      theta.getIncLogLikelihood() = filter->step(rng1, iter2, last, theta,
+          theta.getLogWeights(), theta.getAncestors());
+      filter->sampleTrajectory(rng1, theta.getTrajectory());
+    }
+  }
+
+  for (int i = 0; i < P; ++i) {
+    thetas[i]->getLogLikelihood1() += thetas[i]->getIncLogLikelihood();
+    lws(i) += thetas[i]->getIncLogLikelihood();
+  }
+  iter = iter1;
 }
 
 template<class B, class F, class R, class IO1>
@@ -490,6 +658,10 @@ real bi::SMC2<B,F,R,IO1>::rejuvenate(Random& rng,
   typedef typename temp_host_vector<real>::type host_vector_type;
   typedef typename temp_host_matrix<real>::type host_matrix_type;
 
+  if (L == ON_HOST && !movers.empty()) {
+    return rejuvenateParallel(rng, first, last, s, thetas, q);
+  }
+
   const int P = thetas.size();
   int p, move, naccept = 0;
   bool accept = false;
@@ -507,15 +679,73 @@ real bi::SMC2<B,F,R,IO1>::rejuvenate(Random& rng,
       }
       if (accept) {
         ++naccept;
+        keep(theta, s);
+      }
+    }
+  }
+  return static_cast<double>(naccept) / (Nmoves * P);
+}
 
-        theta.resize(s.size(), false);
-        theta = s;  ///@todo Avoid full copy, especially of cache
+template<class B, class F, class R, class IO1>
+template<bi::Location L, class V1, class M1>
+real bi::SMC2<B,F,R,IO1>::rejuvenateParallel(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last,
+    ThetaParticle<B,L>& s, const std::vector<ThetaParticle<B,L>*>& thetas,
+    GaussianPdf<V1,M1>& q) {
+  const int P = thetas.size();
+  const int N = movers.size();
+  const int seed = rng.uniformInt<int>(0,
+      std::numeric_limits<int>::max() - P);
+  int naccept = 0;
+
+  #pragma omp parallel num_threads(N) reduction(+:naccept)
+  {
+    /* each theta-particle is moved single-threaded, so that only the
+     * generator of the current thread is used */
+    omp_set_num_threads(1);
+
+    F* mover = movers[bi_omp_tid];
+    Random rng1;
+    ThetaParticle<B,L> s1(s.size(), s.getTrajectory().size2());
+    int p, move;
+    bool accept = false;
+
+    /* as each theta-particle has its own seed, dynamic scheduling does not
+     * compromise reproducibility */
+    #pragma omp for schedule(dynamic)
+    for (p = 0; p < P; ++p) {
+      BOOST_AUTO(&theta, *thetas[p]);
+      rng1.seed(seed + p);
+      s1.resize(theta.size());
+      s1 = theta;
+      for (move = 0; move < Nmoves; ++move) {
+        mover->getFilter()->setOutput(&s1.getOutput());
+        if (adapter == NO_ADAPTER) {
+          accept = mover->step(rng1, first, last, s1);
+        } else {
+          accept = mover->step(rng1, first, last, s1, q,
+              adapter == LOCAL_ADAPTER);
+        }
+        if (accept) {
+          ++naccept;
+          keep(theta, s1);
+        }
       }
     }
   }
   return static_cast<double>(naccept) / (Nmoves * P);
 }
 
+template<class B, class F, class R, class IO1>
+template<bi::Location L>
+void bi::SMC2<B,F,R,IO1>::keep(ThetaParticle<B,L>& theta,
+    ThetaParticle<B,L>& s) {
+  theta.swap(s);
+  s.getParameters1() = theta.getParameters1();
+  s.getLogLikelihood1() = theta.getLogLikelihood1();
+  s.getLogPrior1() = theta.getLogPrior1();
+}
+
 template<class B, class F, class R, class IO1>
 template<bi::Location L, class V1>
 void bi::SMC2<B,F,R,IO1>::output(
@@ -11,6 +11,8 @@
 #include "../state/Schedule.hpp"
 #include "../cache/SimulatorCache.hpp"
 #include "../state/State.hpp"
+#include "../ode/IntegratorConfig.hpp"
+#include "../misc/BackgroundThread.hpp"
 
 namespace bi {
 /**
@@ -36,6 +38,11 @@ public:
    */
   Simulator(B& m, F* in = NULL, O* obs = NULL, IO1* out = NULL);
 
+  /**
+   * Destructor.
+   */
+  ~Simulator();
+
   /**
    * @name High-level interface
    *
@@ -84,6 +91,23 @@ public:
    */
   void setOutput(IO1* out);
 
+  /**
+   * Get integrator configuration.
+   *
+   * @return Integrator configuration.
+   */
+  const IntegratorConfig& getIntegratorConfig() const;
+
+  /**
+   * Set integrator configuration.
+   *
+   * @param cfg Integrator configuration.
+   *
+   * Used by all ode blocks of the model. Each block overrides the initial
+   * step size and tolerances with its own @c h, @c atoler and @c rtoler.
+   */
+  void setIntegratorConfig(const IntegratorConfig& cfg);
+
   /**
    * Simulate stochastic model forward.
    *
@@ -114,6 +138,53 @@ public:
   template<Location L, class IO2>
   void simulate(const ScheduleIterator first, const ScheduleIterator last,
       State<B,L>& s, IO2* inInit);
+
+  /**
+   * Read all inputs and observations of a time schedule at once.
+   *
+   * @tparam L Location.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State, used as workspace. Its inputs and observations
+   * are overwritten.
+   *
+   * Subsequent passes over the schedule then make no reads, in particular
+   * the first, which otherwise makes many small reads as it goes.
+   *
+   * @see Forcer::preload(), Observer::preload()
+   */
+  template<Location L>
+  void preload(const ScheduleIterator first, const ScheduleIterator last,
+      State<B,L>& s);
+
+  /**
+   * Read inputs and observations of a time schedule in the background,
+   * ahead of their use.
+   *
+   * @tparam L Location.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State, used as workspace. Its inputs and observations
+   * are overwritten.
+   * @param lookahead Number of input or observation times to read at once.
+   *
+   * This is an alternative to preload() where reading everything up front
+   * would itself take too long. Reads are made on a single thread owned by
+   * this object, shared by the forcer and observer. As NetCDF is not
+   * thread-safe, reads on that thread are confined to a pass over the
+   * schedule: the simulator waits for them before reading the
+   * initialisation file, and at term(). Output written during a pass, as
+   * for the simulate and filter methods, is not compatible with this, so
+   * that prefetching is intended for use by samplers, whose filters
+   * keep their output in memory.
+   *
+   * @see Forcer::prefetch(), Observer::prefetch()
+   */
+  template<Location L>
+  void prefetch(const ScheduleIterator first, const ScheduleIterator last,
+      State<B,L>& s, const int lookahead);
   //@}
 
   /**
@@ -132,7 +203,8 @@ public:
    * @param[in,out] rng Random number generator.
    * @param now Current step in time schedule.
    * @param[out] s State.
-   * @param inInit Initialisation file.
+   * @param inInit Initialisation file. Reads from it are serialised across
+   * host threads, so that threads may initialise from the same file at once.
    */
   template<Location L, class IO2>
   void init(Random& rng, const ScheduleElement now, State<B,L>& s,
@@ -146,7 +218,8 @@ public:
    *
    * @param now Current step in time schedule.
    * @param[out] s State.
-   * @param inInit Initialisation file.
+   * @param inInit Initialisation file. Reads from it are serialised across
+   * host threads, so that threads may initialise from the same file at once.
    */
   template<Location L, class IO2>
   void init(const ScheduleElement now, State<B,L>& s, IO2* inInit = NULL);
@@ -225,6 +298,22 @@ public:
   template<Location L>
   void advance(const ScheduleElement next, State<B,L>& s);
 
+  /**
+   * Advance stochastic model forward, without updating inputs or
+   * observations.
+   *
+   * @tparam L Location.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param next Next step in time schedule.
+   * @param[in,out] s State. Its inputs should be those for @p next.
+   *
+   * This is advance() for particles that missed it, once the inputs for
+   * @p next have been restored.
+   */
+  template<Location L>
+  void transition(Random& rng, const ScheduleElement next, State<B,L>& s);
+
   /**
    * Advance lookahead model forward.
    *
@@ -290,6 +379,21 @@ public:
   //@}
 
 private:
+  /**
+   * Copy constructor, not implemented.
+   */
+  Simulator(const Simulator<B,F,O,IO1>& o);
+
+  /**
+   * Assignment operator, not implemented.
+   */
+  Simulator<B,F,O,IO1>& operator=(const Simulator<B,F,O,IO1>& o);
+
+  /**
+   * Wait for any reads in the background to finish.
+   */
+  void sync();
+
   /**
    * Model.
    */
@@ -309,6 +413,16 @@ private:
    * Output.
    */
   IO1* out;
+
+  /**
+   * Integrator configuration.
+   */
+  IntegratorConfig cfg;
+
+  /**
+   * Thread for prefetching inputs and observations, NULL if none.
+   */
+  BackgroundThread* prefetcher;
 };
 
 /**
@@ -349,10 +463,15 @@ struct SimulatorFactory {
 
 template<class B, class F, class O, class IO1>
 bi::Simulator<B,F,O,IO1>::Simulator(B& m, F* in, O* obs, IO1* out) :
-    m(m), in(in), obs(obs), out(out) {
+    m(m), in(in), obs(obs), out(out), prefetcher(NULL) {
   //
 }
 
+template<class B, class F, class O, class IO1>
+bi::Simulator<B,F,O,IO1>::~Simulator() {
+  delete prefetcher;
+}
+
 template<class B, class F, class O, class IO1>
 inline F* bi::Simulator<B,F,O,IO1>::getInput() {
   return in;
@@ -383,6 +502,17 @@ inline void bi::Simulator<B,F,O,IO1>::setOutput(IO1* out) {
   this->out = out;
 }
 
+template<class B, class F, class O, class IO1>
+inline const bi::IntegratorConfig& bi::Simulator<B,F,O,IO1>::getIntegratorConfig() const {
+  return cfg;
+}
+
+template<class B, class F, class O, class IO1>
+inline void bi::Simulator<B,F,O,IO1>::setIntegratorConfig(
+    const IntegratorConfig& cfg) {
+  this->cfg = cfg;
+}
+
 template<class B, class F, class O, class IO1>
 template<bi::Location L, class IO2>
 void bi::Simulator<B,F,O,IO1>::simulate(Random& rng,
@@ -414,6 +544,36 @@ void bi::Simulator<B,F,O,IO1>::simulate(const ScheduleIterator first,
   term();
 }
 
+template<class B, class F, class O, class IO1>
+template<bi::Location L>
+void bi::Simulator<B,F,O,IO1>::preload(const ScheduleIterator first,
+    const ScheduleIterator last, State<B,L>& s) {
+  if (in != NULL) {
+    in->preload(first, last, s);
+  }
+  if (obs != NULL) {
+    obs->preload(first, last, s);
+  }
+}
+
+template<class B, class F, class O, class IO1>
+template<bi::Location L>
+void bi::Simulator<B,F,O,IO1>::prefetch(const ScheduleIterator first,
+    const ScheduleIterator last, State<B,L>& s, const int lookahead) {
+  /* pre-condition */
+  BI_ASSERT(prefetcher == NULL);
+
+  if (in != NULL || obs != NULL) {
+    prefetcher = new BackgroundThread();
+    if (in != NULL) {
+      in->prefetch(first, last, s, lookahead, prefetcher);
+    }
+    if (obs != NULL) {
+      obs->prefetch(first, last, s, lookahead, prefetcher);
+    }
+  }
+}
+
 template<class B, class F, class O, class IO1>
 template<bi::Location L, class IO2>
 void bi::Simulator<B,F,O,IO1>::init(Random& rng, const ScheduleElement now,
@@ -426,6 +586,8 @@ void bi::Simulator<B,F,O,IO1>::init(Random& rng, const ScheduleElement now,
   /* parameters */
   m.parameterSample(rng, s);
   if (inInit != NULL) {
+    sync();
+    #pragma omp critical(bi_Simulator_inInit)
     inInit->read0(P_VAR, s.get(P_VAR));
     s.get(PY_VAR) = s.get(P_VAR);
     m.parameterSimulate(s);
@@ -439,16 +601,20 @@ void bi::Simulator<B,F,O,IO1>::init(Random& rng, const ScheduleElement now,
   /* state variable initial values */
   m.initialSamples(rng, s);
   if (inInit != NULL) {
-    inInit->read0(D_VAR, s.get(D_VAR));
-    inInit->read0(R_VAR, s.get(D_VAR));
-
-    BOOST_AUTO(iter,
-        std::find(inInit->getTimes().begin(), inInit->getTimes().end(),
-            now.getTime()));
-    if (iter != inInit->getTimes().end()) {
-      int k = std::distance(inInit->getTimes().begin(), iter);
-      inInit->read(k, D_VAR, s.get(D_VAR));
-      inInit->read(k, R_VAR, s.get(R_VAR));
+    sync();
+    #pragma omp critical(bi_Simulator_inInit)
+    {
+      inInit->read0(D_VAR, s.get(D_VAR));
+      inInit->read0(R_VAR, s.get(D_VAR));
+
+      BOOST_AUTO(iter,
+          std::find(inInit->getTimes().begin(), inInit->getTimes().end(),
+              now.getTime()));
+      if (iter != inInit->getTimes().end()) {
+        int k = std::distance(inInit->getTimes().begin(), iter);
+        inInit->read(k, D_VAR, s.get(D_VAR));
+        inInit->read(k, R_VAR, s.get(R_VAR));
+      }
     }
 
     s.get(DY_VAR) = s.get(D_VAR);
@@ -474,6 +640,8 @@ void bi::Simulator<B,F,O,IO1>::init(const ScheduleElement now, State<B,L>& s,
   /* parameters */
   m.parameterSimulate(s);
   if (inInit != NULL) {
+    sync();
+    #pragma omp critical(bi_Simulator_inInit)
     inInit->read0(P_VAR, s.get(P_VAR));
     s.get(PY_VAR) = s.get(P_VAR);
     m.parameterSimulate(s);
@@ -487,14 +655,18 @@ void bi::Simulator<B,F,O,IO1>::init(const ScheduleElement now, State<B,L>& s,
   /* state variable initial values */
   m.initialSimulates(s);
   if (inInit != NULL) {
-    inInit->read0(D_VAR, s.get(D_VAR));
-    inInit->read0(R_VAR, s.get(R_VAR));
-
-    BOOST_AUTO(&times, inInit->getTimes());
-    BOOST_AUTO(iter, std::find(times.begin(), times.end(), now.getTime()));
-    if (iter != times.end()) {
-      inInit->read(std::distance(times.begin(), iter), D_VAR, s.get(D_VAR));
-      inInit->read(std::distance(times.begin(), iter), R_VAR, s.get(R_VAR));
+    sync();
+    #pragma omp critical(bi_Simulator_inInit)
+    {
+      inInit->read0(D_VAR, s.get(D_VAR));
+      inInit->read0(R_VAR, s.get(R_VAR));
+
+      BOOST_AUTO(&times, inInit->getTimes());
+      BOOST_AUTO(iter, std::find(times.begin(), times.end(), now.getTime()));
+      if (iter != times.end()) {
+        inInit->read(std::distance(times.begin(), iter), D_VAR, s.get(D_VAR));
+        inInit->read(std::distance(times.begin(), iter), R_VAR, s.get(R_VAR));
+      }
     }
 
     s.get(DY_VAR) = s.get(D_VAR);
@@ -599,7 +771,8 @@ void bi::Simulator<B,F,O,IO1>::advance(Random& rng,
   if (next.hasInput()) {
     in->update(next.indexInput(), s);
   }
-  m.transitionSamples(rng, next.getFrom(), next.getTo(), next.hasDelta(), s);
+  m.transitionSamples(rng, next.getFrom(), next.getTo(), next.hasDelta(),
+      cfg, s);
   if (next.hasObs()) {
     obs->update(next.indexObs(), s);
   }
@@ -614,12 +787,21 @@ void bi::Simulator<B,F,O,IO1>::advance(const ScheduleElement next,
   if (next.hasInput()) {
     in->update(next.indexInput(), s);
   }
-  m.transitionSimulates(next.getFrom(), next.getTo(), next.hasDelta(), s);
+  m.transitionSimulates(next.getFrom(), next.getTo(), next.hasDelta(), cfg,
+      s);
   if (next.hasObs()) {
     obs->update(next.indexObs(), s);
   }
 }
 
+template<class B, class F, class O, class IO1>
+template<bi::Location L>
+void bi::Simulator<B,F,O,IO1>::transition(Random& rng,
+    const ScheduleElement next, State<B,L>& s) {
+  m.transitionSamples(rng, next.getFrom(), next.getTo(), next.hasDelta(),
+      cfg, s);
+}
+
 template<class B, class F, class O, class IO1>
 template<bi::Location L>
 void bi::Simulator<B,F,O,IO1>::lookahead(Random& rng,
@@ -630,7 +812,7 @@ void bi::Simulator<B,F,O,IO1>::lookahead(Random& rng,
     in->update(next.indexInput(), s);
   }
   m.lookaheadTransitionSamples(rng, next.getFrom(), next.getTo(),
-      next.hasDelta(), s);
+      next.hasDelta(), cfg, s);
   if (next.hasObs()) {
     obs->update(next.indexObs(), s);
   }
@@ -646,7 +828,7 @@ void bi::Simulator<B,F,O,IO1>::lookahead(const ScheduleElement next,
     in->update(next.indexInput(), s);
   }
   m.lookaheadTransitionSimulates(next.getFrom(), next.getTo(),
-      next.hasDelta(), s);
+      next.hasDelta(), cfg, s);
   if (next.hasObs()) {
     obs->update(next.indexObs(), s);
   }
@@ -684,7 +866,14 @@ void bi::Simulator<B,F,O,IO1>::output(const ScheduleElement now,
 
 template<class B, class F, class O, class IO1>
 void bi::Simulator<B,F,O,IO1>::term() {
-  //
+  sync();
+}
+
+template<class B, class F, class O, class IO1>
+void bi::Simulator<B,F,O,IO1>::sync() {
+  if (prefetcher != NULL) {
+    prefetcher->wait();
+  }
 }
 
 #endif
@@ -0,0 +1,109 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#include "BackgroundThread.hpp"
+
+#include "assert.hpp"
+
+/**
+ * Mutex held while running any job, on any thread. Serialises jobs with one
+ * another only; it is not taken by callers.
+ */
+static pthread_mutex_t runMutex = PTHREAD_MUTEX_INITIALIZER;
+
+bi::BackgroundJob::~BackgroundJob() {
+  //
+}
+
+bi::BackgroundThread::BackgroundThread() : job(NULL), started(false),
+    stopping(false) {
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&submitted, NULL);
+  pthread_cond_init(&completed, NULL);
+}
+
+bi::BackgroundThread::~BackgroundThread() {
+  if (started) {
+    pthread_mutex_lock(&mutex);
+    while (job != NULL) {
+      pthread_cond_wait(&completed, &mutex);
+    }
+    stopping = true;
+    pthread_cond_signal(&submitted);
+    pthread_mutex_unlock(&mutex);
+    pthread_join(thread, NULL);
+  }
+  pthread_cond_destroy(&completed);
+  pthread_cond_destroy(&submitted);
+  pthread_mutex_destroy(&mutex);
+}
+
+void bi::BackgroundThread::submit(BackgroundJob* job) {
+  /* pre-condition */
+  BI_ASSERT(job != NULL);
+
+  if (!started) {
+    int err = pthread_create(&thread, NULL, &BackgroundThread::loop, this);
+    BI_ERROR_MSG(err == 0, "Could not start background thread");
+    started = true;
+  }
+
+  pthread_mutex_lock(&mutex);
+  while (this->job != NULL) {
+    pthread_cond_wait(&completed, &mutex);
+  }
+  this->job = job;
+  pthread_cond_signal(&submitted);
+  pthread_mutex_unlock(&mutex);
+}
+
+void bi::BackgroundThread::wait() {
+  pthread_mutex_lock(&mutex);
+  while (job != NULL) {
+    pthread_cond_wait(&completed, &mutex);
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+bool bi::BackgroundThread::isBusy() {
+  bool busy;
+
+  pthread_mutex_lock(&mutex);
+  busy = job != NULL;
+  pthread_mutex_unlock(&mutex);
+
+  return busy;
+}
+
+void* bi::BackgroundThread::loop(void* ptr) {
+  BackgroundThread* self = static_cast<BackgroundThread*>(ptr);
+  BackgroundJob* job;
+
+  pthread_mutex_lock(&self->mutex);
+  while (true) {
+    while (self->job == NULL && !self->stopping) {
+      pthread_cond_wait(&self->submitted, &self->mutex);
+    }
+    if (self->job == NULL) {
+      break;  // stopping, and nothing outstanding
+    }
+    job = self->job;
+
+    /* run without the lock, so that the caller may poll and wait */
+    pthread_mutex_unlock(&self->mutex);
+    pthread_mutex_lock(&runMutex);
+    job->run();
+    pthread_mutex_unlock(&runMutex);
+    pthread_mutex_lock(&self->mutex);
+
+    self->job = NULL;
+    pthread_cond_broadcast(&self->completed);
+  }
+  pthread_mutex_unlock(&self->mutex);
+
+  return NULL;
+}
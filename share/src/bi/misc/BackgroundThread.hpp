@@ -0,0 +1,141 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_MISC_BACKGROUNDTHREAD_HPP
+#define BI_MISC_BACKGROUNDTHREAD_HPP
+
+#include <pthread.h>
+
+namespace bi {
+/**
+ * Job for BackgroundThread.
+ *
+ * @ingroup misc
+ */
+class BackgroundJob {
+public:
+  /**
+   * Destructor.
+   */
+  virtual ~BackgroundJob();
+
+  /**
+   * Run the job.
+   */
+  virtual void run() = 0;
+};
+
+/**
+ * Dedicated thread for running jobs, typically I/O, in the background of
+ * computation.
+ *
+ * @ingroup misc
+ *
+ * At most one job is outstanding at any time: submit() waits for the
+ * previous job to finish before handing over the next. The memory held by
+ * jobs in flight is therefore bounded by that of a single job, and the
+ * caller is held back whenever the background work falls behind.
+ *
+ * The thread is started on the first call to submit(), so that objects that
+ * never submit a job cost nothing. It is not an OpenMP thread, and so should
+ * not use OpenMP itself, nor any library that is not safe to call
+ * concurrently with the work of the caller.
+ *
+ * Jobs on different threads never run at the same time, so that jobs may
+ * share a library, such as NetCDF, that is not thread-safe. This says
+ * nothing of other threads: the caller must not itself use such a library
+ * while a job that uses it is outstanding, and should call wait() first.
+ */
+class BackgroundThread {
+public:
+  /**
+   * Constructor.
+   */
+  BackgroundThread();
+
+  /**
+   * Destructor. Waits for any outstanding job, then stops the thread.
+   */
+  ~BackgroundThread();
+
+  /**
+   * Submit job.
+   *
+   * @param job The job. The caller retains ownership, and must not modify
+   * the job, nor anything that it uses, until the next call to wait() or
+   * submit() returns.
+   *
+   * Waits for any outstanding job to finish first.
+   */
+  void submit(BackgroundJob* job);
+
+  /**
+   * Wait for any outstanding job to finish.
+   */
+  void wait();
+
+  /**
+   * Is there an outstanding job?
+   */
+  bool isBusy();
+
+private:
+  /**
+   * Copy constructor, not implemented.
+   */
+  BackgroundThread(const BackgroundThread& o);
+
+  /**
+   * Assignment operator, not implemented.
+   */
+  BackgroundThread& operator=(const BackgroundThread& o);
+
+  /**
+   * Main loop of the thread.
+   *
+   * @param ptr This object.
+   */
+  static void* loop(void* ptr);
+
+  /**
+   * Thread.
+   */
+  pthread_t thread;
+
+  /**
+   * Mutex for all of the following.
+   */
+  pthread_mutex_t mutex;
+
+  /**
+   * Condition signalled on submission of a job, or to stop.
+   */
+  pthread_cond_t submitted;
+
+  /**
+   * Condition signalled on completion of a job.
+   */
+  pthread_cond_t completed;
+
+  /**
+   * Outstanding job, NULL if none.
+   */
+  BackgroundJob* job;
+
+  /**
+   * Has the thread been started?
+   */
+  bool started;
+
+  /**
+   * Should the thread stop?
+   */
+  bool stopping;
+};
+}
+
+#endif
@@ -32,6 +32,21 @@
  */
 #define BI_ALIGN(n) __attribute((aligned (n)))
 
+/**
+ * @def BI_SSE_ALIGN
+ *
+ * Number of bytes to which to align host buffers, so that they may be
+ * loaded directly into sse_real variables: 16 for SSE, 32 for AVX, 64 for
+ * AVX-512.
+ */
+#if defined(ENABLE_AVX512)
+#define BI_SSE_ALIGN 64
+#elif defined(ENABLE_AVX)
+#define BI_SSE_ALIGN 32
+#else
+#define BI_SSE_ALIGN 16
+#endif
+
 /**
  * @def BI_UNUSED
  *
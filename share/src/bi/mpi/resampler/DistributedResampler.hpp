@@ -8,7 +8,16 @@
 #ifndef BI_MPI_METHOD_DISTRIBUTEDRESAMPLER_HPP
 #define BI_MPI_METHOD_DISTRIBUTEDRESAMPLER_HPP
 
+#include "../mpi.hpp"
+#include "../../state/State.hpp"
+#include "../../resampler/Resampler.hpp"
+
+#include "boost/mpi/request.hpp"
+#include "boost/serialization/access.hpp"
+
 #include <vector>
+#include <list>
+#include <algorithm>
 
 namespace bi {
 /**
@@ -17,6 +26,21 @@ namespace bi {
  * @ingroup method_resampler
  *
  * @tparam R Resampler type.
+ *
+ * Resampling proceeds in two levels, so that no process ever holds the
+ * weights of any other. At the top level, the total number of offspring is
+ * apportioned between processes by systematic resampling over the
+ * per-process sums of weights, which requires only an all-reduce and a
+ * prefix scan of one scalar per process. At the bottom level, each process
+ * then draws its own share of offspring from its local weights using the
+ * base resampler. Offspring are laid out in rank order, so that particles
+ * need only be sent to those processes whose share of the output overlaps
+ * that of the sender, usually its immediate neighbours.
+ *
+ * In asynchronous mode, resample() returns with particles still in transit
+ * between processes. Local offspring are copied into place at the start of
+ * the state, and may be propagated straight away, while arrivals are placed
+ * after them by finish().
  */
 template<class R>
 class DistributedResampler: public Resampler {
@@ -27,8 +51,12 @@ public:
    * @param base Base resampler.
    * @param essRel Minimum ESS, as proportion of total number of particles,
    * to trigger resampling.
+   * @param async Leave the receipt of migrating particles outstanding on
+   * return from resample(), to be completed with finish()? Applies only
+   * when the state is a State object.
    */
-  DistributedResampler(R* base, const double essRel = 0.5);
+  DistributedResampler(R* base, const double essRel = 0.5,
+      const bool async = false);
 
   /**
    * @copydoc concept::Resampler::resample(Random&, V1, V2, O1&)
@@ -44,6 +72,27 @@ public:
   bool isTriggered(const V1 lws) const
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc Resampler::isTriggered(const V1, const WeightStats&) const
+   *
+   * Statistics of local log-weights do not suffice for the global ESS, so
+   * @p ws is ignored.
+   */
+  template<class V1>
+  bool isTriggered(const V1 lws, const WeightStats& ws) const
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc Resampler::numReady
+   */
+  int numReady(const int P) const;
+
+  /**
+   * @copydoc Resampler::finish
+   */
+  template<class V1, class B, Location L>
+  void finish(V1 as, State<B,L>& s);
+
   /**
    * @copydoc Resampler::ess
    */
@@ -52,18 +101,70 @@ public:
       throw (ParticleFilterDegeneratedException);
 
 private:
+  /**
+   * Compute offspring of particles in this process.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights of particles in this process.
+   * @param[out] os Offspring of particles in this process.
+   * @param[out] Ns Cumulative number of offspring over processes.
+   */
+  template<class V1, class V2, class V3>
+  void offspring(Random& rng, const V1 lws, V2 os, V3 Ns)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * Redistribute offspring around processes.
    *
-   * @tparam M1 Matrix type.
-   * @tparam O1
+   * @tparam V1 Integer vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam O1 Compatible with copy() function.
+   *
+   * @param[in,out] os Offspring vector for particles in this process. On
+   * output, gives the number of offspring of each particle now held by this
+   * process, summing to the number of particles in the process.
+   * @param Ns Cumulative number of offspring over processes, so that
+   * offspring of this process occupy the slots <tt>[Ns(rank - 1),
+   * Ns(rank))</tt> of the global output.
+   * @param[in,out] s State.
+   */
+  template<class V1, class V2, class O1>
+  static void redistribute(V1 os, const V2 Ns, O1& s);
+
+  /**
+   * Redistribute offspring around processes, leaving receipt outstanding.
+   *
+   * @tparam V1 Integer vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   * @tparam B Model type.
+   * @tparam L Location.
+   *
+   * @param os Offspring vector for particles in this process.
+   * @param Ns Cumulative number of offspring over processes.
+   * @param[out] as Ancestry. Only the first numReady() elements are set
+   * on return, the remainder are set by finish().
+   * @param[in,out] s State. Only the first numReady() particles are set on
+   * return, the remainder are set by finish().
    *
-   * @param[in,out] O Offspring matrix. Rows index particles, columns index
-   * processes.
-   * @param[in,out] X Matrix of particles in this process.
+   * Particles are sent in one message per destination process, and
+   * received into buffers rather than the state itself, so that local
+   * offspring may be copied into place straight away.
+   */
+  template<class V1, class V2, class V3, class B, Location L>
+  void redistributeAsync(const V1 os, const V2 Ns, V3 as, State<B,L>& s);
+
+  /**
+   * Redistribute offspring around processes, for states that do not support
+   * outstanding receipt. Equivalent to redistribute() followed by the
+   * in-place copy of offspring.
    */
-  template<class M1, class O1>
-  static void redistribute(M1 O, O1& s);
+  template<class V1, class V2, class V3, class T1>
+  void redistributeAsync(V1 os, const V2 Ns, V3 as, std::vector<T1*>& s);
 
   /**
    * @name Timing
@@ -81,54 +182,127 @@ private:
   //@}
 
   /**
-   * Select particle from copy() compatible object.
+   * Serialize particle.
    *
+   * @tparam Archive Archive type.
    * @tparam B Model type.
    * @tparam L Location.
    *
+   * @param ar Archive.
    * @param s State.
-   * @param p Index of particle to select.
-   *
-   * @return Particle.
+   * @param p Index of particle.
    */
-  template<class B, bi::Location L>
-  static typename bi::State<B,L>::matrix_reference_type::vector_reference_type select(
-      State<B,L>& s, const int p);
+  template<class Archive, class B, Location L>
+  static void serialize(Archive& ar, State<B,L>& s, const int p);
 
   /**
-   * Receive particle.
+   * Serialize particle.
    *
-   * @tparam T1 Assignable type.
+   * @tparam Archive Archive type.
+   * @tparam T1 Serializable type.
    *
+   * @param ar Archive.
    * @param s State.
-   * @param p Index of particle to select.
+   * @param p Index of particle.
+   */
+  template<class Archive, class T1>
+  static void serialize(Archive& ar, std::vector<T1*>& s, const int p);
+
+  /**
+   * Particles of a copy() compatible object, serialized together, so that
+   * all those for one process are sent in one message.
    *
-   * @return Particle.
+   * @tparam O1 Compatible with copy() function.
    */
-  template<class T1>
-  static T1& select(std::vector<T1*>& s, const int p);
+  template<class O1>
+  class ParticleBatch {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param s State.
+     */
+    ParticleBatch(O1* s = NULL);
+
+    /**
+     * State.
+     */
+    O1* s;
+
+    /**
+     * Indices of particles in @p s, in order of serialization.
+     */
+    std::vector<int> ps;
+
+  private:
+    /**
+     * Serialize or restore from serialization, the particles in place.
+     */
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned version);
+
+    /*
+     * Boost.Serialization requirements.
+     */
+    friend class boost::serialization::access;
+  };
 
   /**
    * Base resampler.
    */
   R* base;
+
+  /**
+   * Leave receipt of migrating particles outstanding?
+   */
+  bool async;
+
+  /**
+   * Is receipt of migrating particles outstanding?
+   */
+  bool pending;
+
+  /**
+   * Number of particles ready after the last resample, while receipt is
+   * outstanding.
+   */
+  int K;
+
+  /**
+   * Outstanding requests.
+   */
+  std::list<boost::mpi::request> reqs;
+
+  /**
+   * Offspring counts of particles being sent to, and received from, each
+   * process.
+   */
+  std::vector<std::vector<int> > sendos, recvos;
+
+  /**
+   * Particles being sent to, and received from, each process, one per row
+   * in row-major order.
+   */
+  std::vector<std::vector<real> > sendxs, recvxs;
 };
 }
 
-#include "../mpi.hpp"
 #include "../../math/temp_vector.hpp"
 #include "../../math/temp_matrix.hpp"
+#include "../../math/loc_temp_vector.hpp"
+#include "../../math/loc_temp_matrix.hpp"
 #include "../../math/view.hpp"
+#include "../../resampler/SystematicResampler.hpp"
 
 #include "boost/mpi/nonblocking.hpp"
 #include "boost/mpi/collectives.hpp"
-
-#include <list>
+#include "boost/serialization/vector.hpp"
+#include "boost/typeof/typeof.hpp"
 
 template<class R>
 bi::DistributedResampler<R>::DistributedResampler(R* base,
-    const double essRel) :
-    Resampler(essRel), base(base) {
+    const double essRel, const bool async) :
+    Resampler(essRel), base(base), async(async), pending(false), K(0) {
   //
 }
 
@@ -136,6 +310,35 @@ template<class R>
 template<class V1, class V2, class O1>
 void bi::DistributedResampler<R>::resample(Random& rng, V1 lws, V2 as, O1& s)
     throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(!pending);
+
+  boost::mpi::communicator world;
+  const int size = world.size();
+  const int P = lws.size();
+
+  typename temp_host_vector<int>::type os(P), Ns(size);
+
+  offspring(rng, lws, os, Ns);
+  if (async) {
+    redistributeAsync(os, Ns, as, s);
+  } else {
+    redistribute(os, Ns, s);
+    offspringToAncestors(os, as);
+    permute(as);
+    copy(as, s);
+  }
+  lws.clear();
+}
+
+template<class R>
+template<class V1, class V2, class V3>
+void bi::DistributedResampler<R>::offspring(Random& rng, const V1 lws,
+    V2 os, V3 Ns) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(!V2::on_device);
+  BI_ASSERT(!V3::on_device);
+
   typedef typename V1::value_type T1;
 
 #ifdef ENABLE_TIMING
@@ -147,38 +350,52 @@ void bi::DistributedResampler<R>::resample(Random& rng, V1 lws, V2 as, O1& s)
   const int rank = world.rank();
   const int size = world.size();
   const int P = lws.size();
+  const int N = P * size;
 
-  typename temp_host_matrix<real>::type Lws(P, size);
-  typename temp_host_matrix<int>::type O(P, size);
+  typename temp_host_vector<real>::type lws1(P);
+  T1 mx, W1, W, Ws, u;
+  int n1, n2;
 
-  /* gather weights to root */
-  if (V1::on_device) {
-    /* gather takes raw pointer, so need to copy to host */
-    typename temp_host_vector<real>::type lws1(P);
-    lws1 = lws;
-    synchronize();
-    boost::mpi::gather(world, lws1.buf(), P, vec(Lws).buf(), 0);
-  } else {
-    /* already on host */
-    boost::mpi::gather(world, lws.buf(), P, vec(Lws).buf(), 0);
+  /* total and prefix sum of weights over processes */
+  mx = max_reduce(lws);
+  mx = boost::mpi::all_reduce(world, mx, boost::mpi::maximum<T1>());
+  W1 = op_reduce(lws, nan_minus_and_exp_functor<T1>(mx), 0.0,
+      thrust::plus<T1>());
+  W = boost::mpi::all_reduce(world, W1, std::plus<T1>());
+  Ws = boost::mpi::scan(world, W1, std::plus<T1>());
+  if (!(W > 0.0)) {
+    throw ParticleFilterDegeneratedException();
   }
 
-  /* compute offspring on root and broadcast */
+  /* common offset into strata for the top level */
   if (rank == 0) {
-    base->offspring(rng, vec(Lws), vec(O), P * size);
+    u = rng.uniform((T1)0.0, (T1)1.0);
+  }
+  boost::mpi::broadcast(world, u, 0);
+
+  /* cumulative number of offspring up to and including this process; the
+   * last process takes any remainder due to rounding in the scan */
+  if (rank == size - 1) {
+    n2 = N;
+  } else {
+    n2 = resample_cumulative_offspring<T1>(u, W, N)(Ws);
+  }
+  boost::mpi::all_gather(world, n2, Ns.buf());
+  n1 = (rank > 0) ? Ns(rank - 1) : 0;
+
+  /* offspring of local particles */
+  if (n2 > n1) {
+    lws1 = lws;
+    synchronize(V1::on_device);
+    base->offspring(rng, lws1, os, n2 - n1);
+  } else {
+    os.clear();
   }
-  boost::mpi::broadcast(world, O, 0);
 
 #ifdef ENABLE_TIMING
   long usecs = clock.toc();
   reportResample(rank, usecs);
 #endif
-
-  redistribute(O, s);
-  offspringToAncestors(column(O, rank), as);
-  permute(as);
-  copy(as, s);
-  lws.clear();
 }
 
 template<class R>
@@ -200,6 +417,13 @@ bool bi::DistributedResampler<R>::isTriggered(const V1 lws) const
   return essRel >= 1.0 || ess(lws) < essRel * size * P;
 }
 
+template<class R>
+template<class V1>
+bool bi::DistributedResampler<R>::isTriggered(const V1 lws,
+    const WeightStats& ws) const throw (ParticleFilterDegeneratedException) {
+  return isTriggered(lws);
+}
+
 template<class R>
 template<class V1>
 typename V1::value_type bi::DistributedResampler<R>::ess(const V1 lws)
@@ -230,9 +454,11 @@ typename V1::value_type bi::DistributedResampler<R>::ess(const V1 lws)
 }
 
 template<class R>
-template<class M1, class O1>
-void bi::DistributedResampler<R>::redistribute(M1 O, O1& s) {
-  typedef typename temp_host_vector<int>::type int_vector_type;
+template<class V1, class V2, class O1>
+void bi::DistributedResampler<R>::redistribute(V1 os, const V2 Ns, O1& s) {
+  /* pre-condition */
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
 
 #ifdef ENABLE_TIMING
   synchronize();
@@ -242,78 +468,263 @@ void bi::DistributedResampler<R>::redistribute(M1 O, O1& s) {
   boost::mpi::communicator world;
   const int rank = world.rank();
   const int size = world.size();
-  const int P = O.size1();
-
-  int sendi, recvi, sendj, recvj, sendn, recvn, n, sendr, recvr, tag = 0;
+  const int P = os.size();
 
-  int_vector_type Ps(size);  // number of particles in each process
-  int_vector_type ranks(size);  // ranks sorted by number of particles
+  typename temp_host_vector<int>::type ks(P);  // offspring kept locally
+  std::vector<ParticleBatch<O1> > sendbs(size, ParticleBatch<O1>(&s));
+  std::vector<ParticleBatch<O1> > recvbs(size, ParticleBatch<O1>(&s));
+  std::vector<std::vector<int> > sendos(size);
+  std::vector<int> recvos;
   std::list<boost::mpi::request> reqs;
+  int i, j, k, n, n1, n2, g, d, q, first, last, recvi;
+
+  /* split offspring of each particle by destination process, the global
+   * slot of each offspring determining its destination */
+  ks.clear();
+  g = (rank > 0) ? Ns(rank - 1) : 0;
+  for (i = 0; i < P; ++i) {
+    n = os(i);
+    while (n > 0) {
+      d = g / P;
+      k = bi::min(n, (d + 1) * P - g);
+      if (d == rank) {
+        ks(i) = k;
+      } else {
+        sendbs[d].ps.push_back(i);
+        sendos[d].push_back(k);
+      }
+      g += k;
+      n -= k;
+    }
+  }
 
-  sum_rows(O, Ps);
-  seq_elements(ranks, 0);
-  sort_by_key(Ps, ranks);
+  /* send, to each overlapping process, the number of offspring of each
+   * particle, then the particles themselves in one message; particles are
+   * serialized on send, so that their slots may be reused for receipt
+   * below */
+  for (d = 0; d < size; ++d) {
+    if (!sendbs[d].ps.empty()) {
+      reqs.push_back(world.isend(d, 0, sendos[d]));
+      reqs.push_back(world.isend(d, 1, sendbs[d]));
+    }
+  }
 
-  /* redistribute offspring */
-  sendj = size - 1;
-  recvj = 0;
-  sendi = 0;
+  /* receive, from each overlapping process in rank order, into slots with
+   * no offspring kept locally */
+  os = ks;
   recvi = 0;
+  first = rank * P;
+  last = first + P;
+  for (q = 0; q < size; ++q) {
+    n1 = (q > 0) ? Ns(q - 1) : 0;
+    n2 = Ns(q);
+    if (q != rank && n1 < last && n2 > first && n2 > n1) {
+      world.recv(q, 0, recvos);
+      for (j = 0; j < (int)recvos.size(); ++j) {
+        while (ks(recvi) > 0) {
+          ++recvi;
+        }
+        BI_ASSERT(recvi < P);
+        os(recvi) = recvos[j];
+        recvbs[q].ps.push_back(recvi);
+        ++recvi;
+      }
+      reqs.push_back(world.irecv(q, 1, recvbs[q]));
+    }
+  }
 
-  while (Ps(sendj) > P) {
-    /* ranks */
-    sendr = ranks(sendj);
-    recvr = ranks(recvj);
+  /* wait for all copies to complete */
+  boost::mpi::wait_all(reqs.begin(), reqs.end());
 
-    /* advance to first nonzero of sender */
-    while (O(sendi, sendr) == 0) {
-      ++sendi;
-    }
+  /* post-condition */
+  BI_ASSERT(sum_reduce(os) == P);
 
-    /* advance to first zero of receiver */
-    while (O(recvi, recvr) > 0) {
-      ++recvi;
-    }
+#ifdef ENABLE_TIMING
+  long usecs = clock.toc();
+  reportRedistribute(rank, usecs);
+#endif
+}
+
+template<class R>
+template<class V1, class V2, class V3, class B, bi::Location L>
+void bi::DistributedResampler<R>::redistributeAsync(const V1 os,
+    const V2 Ns, V3 as, State<B,L>& s) {
+  /* pre-condition */
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  const int size = world.size();
+  const int P = os.size();
+  const int N = s.getDyn().size2();
+
+  typename temp_host_vector<int>::type ks(P);  // offspring kept locally
+  std::vector<std::vector<int> > sendps(size);
+  std::vector<int> sendis;
+  int i, j, c, k, n, n1, n2, g, d, q, first, last;
+
+  sendos.resize(size);
+  sendxs.resize(size);
+  recvos.resize(size);
+  recvxs.resize(size);
+  for (q = 0; q < size; ++q) {
+    sendos[q].clear();
+    sendxs[q].clear();
+    recvos[q].clear();
+    recvxs[q].clear();
+  }
 
-    /* determine number of offspring to transfer */
-    recvn = P - Ps(recvj);  // max to receive
-    sendn = bi::min(Ps(sendj) - P, O(sendi, sendr));  // max to send
-    n = bi::min(recvn, sendn);  // actual to transfer
-
-    /* update offspring */
-    O(sendi, sendr) -= n;
-    O(recvi, recvr) += n;
-
-    /* update particle counts */
-    Ps(sendj) -= n;
-    Ps(recvj) += n;
-    BI_ASSERT(Ps(sendj) >= P);
-    BI_ASSERT(Ps(recvj) <= P);
-
-    /* transfer particle */
-    if (rank == recvr) {
-      reqs.push_back(world.irecv(sendr, tag, select(s, recvi)));
-    } else if (rank == sendr) {
-      reqs.push_back(world.isend(recvr, tag, select(s, sendi)));
+  /* split offspring of each particle by destination process, as in
+   * redistribute() */
+  ks.clear();
+  g = (rank > 0) ? Ns(rank - 1) : 0;
+  for (i = 0; i < P; ++i) {
+    n = os(i);
+    while (n > 0) {
+      d = g / P;
+      k = bi::min(n, (d + 1) * P - g);
+      if (d == rank) {
+        ks(i) = k;
+      } else {
+        sendps[d].push_back(i);
+        sendos[d].push_back(k);
+      }
+      g += k;
+      n -= k;
     }
-    ++tag;
+  }
 
-    if (Ps(sendj) == P) {
-      --sendj;
-      sendi = 0;
+  /* post receipt of offspring counts and particles from each overlapping
+   * process; counts are zero-padded, as the number of distinct particles is
+   * not known in advance */
+  first = rank * P;
+  last = first + P;
+  for (q = 0; q < size; ++q) {
+    n1 = (q > 0) ? Ns(q - 1) : 0;
+    n2 = Ns(q);
+    if (q != rank && n1 < last && n2 > first && n2 > n1) {
+      n = bi::min(n2, last) - bi::max(n1, first);
+      recvos[q].resize(n, 0);
+      recvxs[q].resize(n * N);
+      reqs.push_back(world.irecv(q, 0, &recvos[q][0], n));
+      reqs.push_back(world.irecv(q, 1, &recvxs[q][0], n * N));
     }
-    if (Ps(recvj) == P) {
-      ++recvj;
-      recvi = 0;
+  }
+
+  /* gather the rows of just those particles to be sent, in order of
+   * destination, before local offspring are copied into place */
+  for (d = 0; d < size; ++d) {
+    sendis.insert(sendis.end(), sendps[d].begin(), sendps[d].end());
+  }
+  n = sendis.size();
+  typename temp_host_matrix<real>::type X(n, N);
+  if (n > 0) {
+    typename temp_host_vector<int>::type is(n);
+    typename loc_temp_vector<L,int>::type is1(n);
+    typename loc_temp_matrix<L,real>::type X1(n, N);
+
+    std::copy(sendis.begin(), sendis.end(), is.begin());
+    is1 = is;
+    bi::gather_rows(is1, s.getDyn(), X1);
+    X = X1;
+    synchronize(L == ON_DEVICE);
+  }
+
+  /* pack and send particles to each overlapping process */
+  i = 0;
+  for (d = 0; d < size; ++d) {
+    n = sendps[d].size();
+    if (n > 0) {
+      sendxs[d].resize(n * N);
+      for (j = 0; j < n; ++j) {
+        for (c = 0; c < N; ++c) {
+          sendxs[d][j * N + c] = X(i + j, c);
+        }
+      }
+      reqs.push_back(world.isend(d, 0, &sendos[d][0], n));
+      reqs.push_back(world.isend(d, 1, &sendxs[d][0], n * N));
+      i += n;
     }
   }
 
+  /* copy local offspring into place at the start of the state */
+  K = sum_reduce(ks);
+  if (K > 0) {
+    typename temp_host_vector<int>::type as1(K);
+    offspringToAncestors(ks, as1);
+    permute(as1);
+    subrange(as, 0, K) = as1;
+    copy(subrange(as, 0, K), s.getDyn());
+  }
+  pending = true;
+}
+
+template<class R>
+template<class V1, class V2, class V3, class T1>
+void bi::DistributedResampler<R>::redistributeAsync(V1 os, const V2 Ns,
+    V3 as, std::vector<T1*>& s) {
+  redistribute(os, Ns, s);
+  offspringToAncestors(os, as);
+  permute(as);
+  copy(as, s);
+}
+
+template<class R>
+int bi::DistributedResampler<R>::numReady(const int P) const {
+  return pending ? K : P;
+}
+
+template<class R>
+template<class V1, class B, bi::Location L>
+void bi::DistributedResampler<R>::finish(V1 as, State<B,L>& s) {
+  if (!pending) {
+    return;
+  }
+
+#ifdef ENABLE_TIMING
+  synchronize();
+  TicToc clock;
+#endif
+
+  boost::mpi::communicator world;
+  const int P = s.size();
+  const int N = s.getDyn().size2();
+
+  int i, j, k, q, o, c;
+
   /* wait for all copies to complete */
   boost::mpi::wait_all(reqs.begin(), reqs.end());
+  reqs.clear();
+
+  /* unpack arrivals, with their offspring, after local offspring */
+  if (K < P) {
+    typename temp_host_matrix<real>::type Y(P - K, N);
+    typename temp_host_vector<int>::type as1(P - K);
+
+    i = 0;
+    for (q = 0; q < (int)recvos.size(); ++q) {
+      for (j = 0; j < (int)recvos[q].size() && recvos[q][j] > 0; ++j) {
+        o = recvos[q][j];
+        for (k = 0; k < o; ++k) {
+          for (c = 0; c < N; ++c) {
+            Y(i + k, c) = recvxs[q][j * N + c];
+          }
+          as1(i + k) = K + i;
+        }
+        i += o;
+      }
+    }
+    BI_ASSERT(i == P - K);
+
+    rows(s.getDyn(), K, P - K) = Y;
+    subrange(as, K, P - K) = as1;
+  }
+  pending = false;
 
 #ifdef ENABLE_TIMING
   long usecs = clock.toc();
-  reportRedistribute(rank, usecs);
+  reportRedistribute(world.rank(), usecs);
 #endif
 }
 
@@ -326,16 +737,34 @@ void bi::DistributedResampler<R>::reportRedistribute(int rank, long usecs) {
 }
 
 template<class R>
-template<class B, bi::Location L>
-typename bi::State<B,L>::matrix_reference_type::vector_reference_type bi::DistributedResampler<
-    R>::select(State<B,L>& s, const int p) {
-  return row(s.getDyn(), p);
+template<class Archive, class B, bi::Location L>
+void bi::DistributedResampler<R>::serialize(Archive& ar, State<B,L>& s,
+    const int p) {
+  BOOST_AUTO(x, row(s.getDyn(), p));
+  ar & x;
+}
+
+template<class R>
+template<class Archive, class T1>
+void bi::DistributedResampler<R>::serialize(Archive& ar,
+    std::vector<T1*>& s, const int p) {
+  ar & *s[p];
 }
 
 template<class R>
-template<class T1>
-T1& bi::DistributedResampler<R>::select(std::vector<T1*>& s, const int p) {
-  return *s[p];
+template<class O1>
+bi::DistributedResampler<R>::ParticleBatch<O1>::ParticleBatch(O1* s) : s(s) {
+  //
+}
+
+template<class R>
+template<class O1>
+template<class Archive>
+void bi::DistributedResampler<R>::ParticleBatch<O1>::serialize(Archive& ar,
+    const unsigned version) {
+  for (int j = 0; j < (int)ps.size(); ++j) {
+    DistributedResampler<R>::serialize(ar, *s, ps[j]);
+  }
 }
 
 #endif
@@ -10,6 +10,7 @@
 
 #include "../misc/location.hpp"
 #include "../state/State.hpp"
+#include "IntegratorConfig.hpp"
 
 namespace bi {
 /**
@@ -20,16 +21,25 @@ namespace bi {
  *
  * @tparam B Model type.
  * @tparam S Action type list.
+ * @tparam XH Variable type in which to carry step size between calls.
+ * @tparam XT Variable type in which to carry time between calls.
+ *
+ * Each trajectory records, in @p XH and @p XT, the step size proposed by
+ * the step size controller when it stops and the time at which it stops.
+ * If the next call begins at that time, the trajectory resumes with that
+ * step size, rather than starting again from IntegratorConfig::h0.
  */
-template<class B, class S>
+template<class B, class S, class XH, class XT>
 class DOPRI5Integrator {
 public:
   template<class T1>
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 
   #ifdef __CUDACC__
   template<class T1>
-  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_DEVICE>& s);
   #endif
 };
 
@@ -43,36 +53,33 @@ public:
 #include "../cuda/ode/DOPRI5IntegratorGPU.cuh"
 #endif
 
-template<class B, class S>
+template<class B, class S, class XH, class XT>
 template<class T1>
-void bi::DOPRI5Integrator<B,S>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+void bi::DOPRI5Integrator<B,S,XH,XT>::update(const IntegratorConfig& cfg, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
   /* pre-conditions */
   BI_ASSERT(t1 <= t2);
 
   if (bi::abs(t2 - t1) > 0.0) {
     #ifdef ENABLE_SSE
-    if (s.size() % BI_SSE_SIZE == 0) {
-      DOPRI5IntegratorSSE<B,S,T1>::update(t1, t2, s);
-    } else {
-      DOPRI5IntegratorHost<B,S,T1>::update(t1, t2, s);
-    }
+    sse_host_update<DOPRI5IntegratorHost<B,S,XH,XT,T1>,
+        DOPRI5IntegratorSSE<B,S,XH,XT,T1> >(cfg, t1, t2, s);
     #else
-    DOPRI5IntegratorHost<B,S,T1>::update(t1, t2, s);
+    DOPRI5IntegratorHost<B,S,XH,XT,T1>::update(cfg, t1, t2, s);
     #endif
   }
 }
 
 #ifdef __CUDACC__
-template<class B, class S>
+template<class B, class S, class XH, class XT>
 template<class T1>
-void bi::DOPRI5Integrator<B,S>::update(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE>& s) {
+void bi::DOPRI5Integrator<B,S,XH,XT>::update(const IntegratorConfig& cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE>& s) {
   /* pre-conditions */
   BI_ASSERT(t1 <= t2);
 
   if (bi::abs(t2 - t1) > 0.0) {
-    DOPRI5IntegratorGPU<B,S,T1>::update(t1, t2, s);
+    DOPRI5IntegratorGPU<B,S,XH,XT,T1>::update(cfg, t1, t2, s);
   }
 }
 #endif
@@ -0,0 +1,222 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_ODE_INTEGRATORCONFIG_HPP
+#define BI_ODE_INTEGRATORCONFIG_HPP
+
+#include "../cuda/cuda.hpp"
+#include "../math/scalar.hpp"
+
+namespace bi {
+/**
+ * Configuration of ODE integrators.
+ *
+ * @ingroup method_updater
+ *
+ * Holds the tolerances and step size controls of an integrator, along with
+ * quantities precalculated from them. Each integration is given its own
+ * configuration, so that models, or blocks of the same model, with
+ * different settings may be integrated concurrently. The configuration is
+ * small, and is passed by value to device kernels.
+ *
+ * Step size control is adapted from IntegratorT from Blake Ashby
+ * <bmashby@stanford.edu>, see NonStiffIntegrator there.
+ */
+struct IntegratorConfig {
+  /**
+   * Constructor.
+   *
+   * @param h0 Initial step size.
+   * @param atoler Absolute error tolerance.
+   * @param rtoler Relative error tolerance.
+   *
+   * All other settings take their default values.
+   */
+  IntegratorConfig(const real h0 = BI_REAL(1.0e-2),
+      const real atoler = BI_REAL(1.0e-7),
+      const real rtoler = BI_REAL(1.0e-7));
+
+  /**
+   * Set rounding unit. Smallest number satisfying 1.0 + uround > 1.0.
+   */
+  void setUround(const real uround);
+
+  /**
+   * Set safety factor in step size prediction.
+   */
+  void setSafe(const real safe);
+
+  /**
+   * Set the "beta" for stabilized step size control (see section IV.2 of
+   * Hairer and Wanner's book). Larger values for beta (<= 0.1) make
+   * the step size control more stable. This program needs a larger
+   * beta than Higham & Hall. Negative initial value provoke beta = 0.0.
+   */
+  void setBeta(const real beta);
+
+  /**
+   * facl, facr--parameters for step size selection; the new step size is
+   * chosen subject to the restriction  facl <= hnew/hold <= facr.
+   * Default values are facl = 0.2 and facr = 10.0.
+   */
+  void setFacl(const real facl);
+
+  /**
+   * @copydoc setFacl
+   */
+  void setFacr(const real facr);
+
+  /**
+   * Set maximum number of steps before prematurely ending integration.
+   */
+  void setNsteps(const int nsteps);
+
+  /**
+   * Set whether trajectories integrated together with SSE instructions
+   * share a common step size, chosen for the largest error among them, or
+   * each have their own step size.
+   */
+  void setLockstep(const bool lockstep);
+
+  /**
+   * Set whether trajectories integrated on host without SSE instructions
+   * are integrated in tiles, as by DOPRI5IntegratorHost, or one at a time.
+   */
+  void setTiled(const bool tiled);
+
+  /**
+   * Initial step size.
+   */
+  real h0;
+
+  /**
+   * Relative error tolerance.
+   */
+  real rtoler;
+
+  /**
+   * Absolute error tolerance.
+   */
+  real atoler;
+
+  /**
+   * Rounding unit.
+   */
+  real uround;
+
+  /**
+   * Safety factor in step size prediction.
+   */
+  real safe;
+
+  /**
+   * Lower bound on ratio of new to old step size.
+   */
+  real facl;
+
+  /**
+   * Upper bound on ratio of new to old step size.
+   */
+  real facr;
+
+  /**
+   * Maximum number of steps before prematurely ending integration.
+   */
+  int nsteps;
+
+  /**
+   * The "beta" for stabilized step size control.
+   */
+  real beta;
+
+  /**
+   * Use a common step size for all trajectories integrated together with
+   * SSE instructions?
+   */
+  bool lockstep;
+
+  /**
+   * Integrate trajectories on host in tiles?
+   */
+  bool tiled;
+
+  /*
+   * Precalculations.
+   */
+  real expo1;
+  real expo;
+  real facc1;
+  real facc2;
+  real logsafe;
+  real safe1;
+};
+}
+
+#include "../math/function.hpp"
+#include "../misc/assert.hpp"
+
+inline bi::IntegratorConfig::IntegratorConfig(const real h0,
+    const real atoler, const real rtoler) : h0(h0), rtoler(rtoler),
+    atoler(atoler) {
+  setUround(BI_REAL(1.0e-16));
+  setSafe(BI_REAL(0.9));
+  setFacl(BI_REAL(0.2));
+  setFacr(BI_REAL(10.0));
+  setBeta(BI_REAL(0.04));
+  setNsteps(1000);
+  setLockstep(false);
+  setTiled(true);
+}
+
+inline void bi::IntegratorConfig::setUround(const real uround) {
+  /* pre-condition */
+  BI_ASSERT(uround > BI_REAL(1.0e-19) && uround < BI_REAL(1.0));
+
+  this->uround = uround;
+}
+
+inline void bi::IntegratorConfig::setSafe(const real safe) {
+  /* pre-condition */
+  BI_ASSERT(safe > BI_REAL(0.001) && safe < BI_REAL(1.0));
+
+  this->safe = safe;
+  safe1 = BI_REAL(1.0)/safe;
+  logsafe = bi::log(safe);
+}
+
+inline void bi::IntegratorConfig::setBeta(const real beta) {
+  /* pre-condition */
+  BI_ASSERT(beta >= 0.0 && beta <= BI_REAL(0.2));
+
+  this->beta = beta;
+  expo1 = BI_REAL(0.2) - beta*BI_REAL(0.75);
+  expo = BI_REAL(0.5)*(BI_REAL(0.2) - beta*BI_REAL(0.75));
+}
+
+inline void bi::IntegratorConfig::setFacl(const real facl) {
+  this->facl = facl;
+  facc1 = BI_REAL(1.0)/facl;
+}
+
+inline void bi::IntegratorConfig::setFacr(const real facr) {
+  this->facr = facr;
+  facc2 = BI_REAL(1.0)/facr;
+}
+
+inline void bi::IntegratorConfig::setNsteps(const int nsteps) {
+  this->nsteps = nsteps;
+}
+
+inline void bi::IntegratorConfig::setLockstep(const bool lockstep) {
+  this->lockstep = lockstep;
+}
+
+inline void bi::IntegratorConfig::setTiled(const bool tiled) {
+  this->tiled = tiled;
+}
+
+#endif
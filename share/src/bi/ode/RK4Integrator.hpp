@@ -10,6 +10,7 @@
 
 #include "../misc/location.hpp"
 #include "../state/State.hpp"
+#include "IntegratorConfig.hpp"
 
 namespace bi {
 /**
@@ -24,11 +25,13 @@ template<class B, class S>
 class RK4Integrator {
 public:
   template<class T1>
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 
   #ifdef __CUDACC__
   template<class T1>
-  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_DEVICE>& s);
   #endif
 };
 
@@ -44,20 +47,17 @@ public:
 
 template<class B, class S>
 template<class T1>
-void bi::RK4Integrator<B,S>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+void bi::RK4Integrator<B,S>::update(const IntegratorConfig& cfg, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
   /* pre-conditions */
   BI_ASSERT(t1 <= t2);
 
   if (bi::abs(t2 - t1) > 0.0) {
     #ifdef ENABLE_SSE
-    if (s.size() % BI_SSE_SIZE == 0) {
-      RK4IntegratorSSE<B,S,T1>::update(t1, t2, s);
-    } else {
-      RK4IntegratorHost<B,S,T1>::update(t1, t2, s);
-    }
+    sse_host_update<RK4IntegratorHost<B,S,T1>,
+        RK4IntegratorSSE<B,S,T1> >(cfg, t1, t2, s);
     #else
-    RK4IntegratorHost<B,S,T1>::update(t1, t2, s);
+    RK4IntegratorHost<B,S,T1>::update(cfg, t1, t2, s);
     #endif
   }
 }
@@ -65,13 +65,13 @@ void bi::RK4Integrator<B,S>::update(const T1 t1, const T1 t2,
 #ifdef __CUDACC__
 template<class B, class S>
 template<class T1>
-void bi::RK4Integrator<B,S>::update(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE>& s) {
+void bi::RK4Integrator<B,S>::update(const IntegratorConfig& cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE>& s) {
   /* pre-conditions */
   BI_ASSERT(t1 <= t2);
 
   if (bi::abs(t2 - t1) > 0.0) {
-    RK4IntegratorGPU<B,S,T1>::update(t1, t2, s);
+    RK4IntegratorGPU<B,S,T1>::update(cfg, t1, t2, s);
   }
 }
 #endif
@@ -0,0 +1,70 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_ODE_ROS23INTEGRATOR_HPP
+#define BI_ODE_ROS23INTEGRATOR_HPP
+
+#include "../misc/location.hpp"
+#include "../state/State.hpp"
+#include "IntegratorConfig.hpp"
+
+namespace bi {
+/**
+ * Update using Rosenbrock 2(3) integrator with adaptive step-size control,
+ * for stiff systems.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ *
+ * Actions must provide a @c jacobian function as well as @c dfdt. The
+ * integrator is implemented on host only.
+ */
+template<class B, class S>
+class ROS23Integrator {
+public:
+  template<class T1>
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+  #ifdef __CUDACC__
+  template<class T1>
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_DEVICE>& s);
+  #endif
+};
+
+}
+
+#include "../host/ode/ROS23IntegratorHost.hpp"
+
+template<class B, class S>
+template<class T1>
+void bi::ROS23Integrator<B,S>::update(const IntegratorConfig& cfg, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-conditions */
+  BI_ASSERT(t1 <= t2);
+
+  if (bi::abs(t2 - t1) > 0.0) {
+    ROS23IntegratorHost<B,S,T1>::update(cfg, t1, t2, s);
+  }
+}
+
+#ifdef __CUDACC__
+template<class B, class S>
+template<class T1>
+void bi::ROS23Integrator<B,S>::update(const IntegratorConfig& cfg, const T1 t1,
+    const T1 t2, State<B,ON_DEVICE>& s) {
+  /* pre-conditions */
+  BI_ASSERT(t1 <= t2);
+
+  BI_ERROR_MSG(false, "ROS2(3) integrator not supported on device");
+}
+#endif
+
+#endif
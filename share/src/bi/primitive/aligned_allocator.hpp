@@ -8,16 +8,18 @@
 #ifndef BI_MISC_ALIGNED_ALLOCATOR_HPP
 #define BI_MISC_ALIGNED_ALLOCATOR_HPP
 
+#include "../misc/compile.hpp"
+
 #include <cstdlib>
 
 namespace bi {
 /**
  * Allocator for aligned memory. Useful to align buffers for ready loading
- * of SSE 128-bit values.
+ * of SSE values. The default alignment is #BI_SSE_ALIGN.
  *
  * @ingroup primitive_allocators
  */
-template <class T, unsigned X = 16>
+template <class T, unsigned X = BI_SSE_ALIGN>
 class aligned_allocator {
 public:
   typedef size_t size_type;
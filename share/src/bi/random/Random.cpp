@@ -13,6 +13,7 @@
 
 bi::Random::Random() : own(true) {
   hostRngs = new RngHost[bi_omp_max_threads];
+  hostSteps = new unsigned(0);
   #ifdef ENABLE_CUDA
   CUDA_CHECKED_CALL(cudaMalloc(&devRngs,
       deviceIdealThreads()*sizeof(curandState)));
@@ -21,6 +22,7 @@ bi::Random::Random() : own(true) {
 
 bi::Random::Random(const unsigned seed) : own(true) {
   hostRngs = new RngHost[bi_omp_max_threads];
+  hostSteps = new unsigned(0);
   #ifdef ENABLE_CUDA
   CUDA_CHECKED_CALL(cudaMalloc(&devRngs,
       deviceIdealThreads()*sizeof(curandState)));
@@ -30,6 +32,7 @@ bi::Random::Random(const unsigned seed) : own(true) {
 
 bi::Random::Random(const Random& o) {
   hostRngs = o.hostRngs;
+  hostSteps = o.hostSteps;
   #ifdef ENABLE_CUDA
   devRngs = o.devRngs;
   #endif
@@ -40,6 +43,8 @@ bi::Random::~Random() {
   if (own) {
     delete[] hostRngs;
     hostRngs = NULL;
+    delete hostSteps;
+    hostSteps = NULL;
     #ifdef ENABLE_CUDA
     CUDA_CHECKED_CALL(cudaFree(devRngs));
     devRngs = NULL;
@@ -48,6 +53,7 @@ bi::Random::~Random() {
 }
 
 void bi::Random::seeds(const unsigned seed) {
+  *hostSteps = 0;
   RandomHost::seeds(*this, seed);
   #ifdef ENABLE_CUDA
   RandomGPU::seeds(*this, seed);
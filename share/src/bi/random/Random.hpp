@@ -74,9 +74,13 @@ public:
    */
   //@{
   /**
-   * Seed random number generator.
+   * Seed random number generator of the current thread.
    *
    * @param seed Seed value.
+   *
+   * Also resets the count of steps, see step(). Under @c ENABLE_PHILOX, the
+   * variates then drawn depend only on @p seed, not on the thread that
+   * draws them, nor on the draws made before.
    */
   void seed(const unsigned seed);
 
@@ -249,6 +253,20 @@ public:
    */
   RngHost& getHostRng();
 
+  /**
+   * Take steps, for use with RngHost::beginStream().
+   *
+   * @param n Number of steps.
+   *
+   * @return First step number. This and the following <tt>n - 1</tt> step
+   * numbers are unique to this call since the last call to seeds() or
+   * seed(), and are those that @p n separate calls would have returned.
+   *
+   * Call outside of any parallel region. Copies of this object share the
+   * same count of steps.
+   */
+  unsigned step(const unsigned n = 1);
+
 #ifdef ENABLE_CUDA
   /**
    * Get a thread's random number generator.
@@ -265,6 +283,11 @@ public:
    */
   RngHost* hostRngs;
 
+  /**
+   * Count of steps on host.
+   */
+  unsigned* hostSteps;
+
 #ifdef ENABLE_CUDA
   /**
    * Random number generators on device.
@@ -287,6 +310,7 @@ public:
 #endif
 
 inline void bi::Random::seed(const unsigned seed) {
+  *hostSteps = 0;
   getHostRng().seed(seed);
 }
 
@@ -373,6 +397,12 @@ inline bi::RngHost& bi::Random::getHostRng() {
   return hostRngs[bi_omp_tid];
 }
 
+inline unsigned bi::Random::step(const unsigned n) {
+  const unsigned t = *hostSteps;
+  *hostSteps += n;
+  return t;
+}
+
 #ifdef ENABLE_CUDA
 inline curandState& bi::Random::getDevRng(const int p) {
   return devRngs[p];
@@ -30,6 +30,27 @@ public:
    */
   template<class V1, class V2>
   static void ancestorsPermute(Random& rng, const V1 lws, V2 as, int B);
+
+  /**
+   * Select ancestors for each of several groups.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights.
+   * @param[out] as Ancestors.
+   * @param Ps Group offsets.
+   * @param B Number of Metropolis steps to take.
+   *
+   * Group @c g uses the step that the @c g th of separate calls to
+   * ancestors() would, so that, with counter-based random number
+   * generation, the result is that of those separate calls.
+   */
+  template<class V1, class V2, class V3>
+  static void ancestors(Random& rng, const V1 lws, V2 as, const V3 Ps,
+      int B);
 };
 
 /**
@@ -109,6 +130,13 @@ public:
   template<class V1, class V2, class O1>
   void cond_resample(Random& rng, const int ka, const int k, V1 lws, V2 as,
       O1& s) throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::seg_resample(Random&, V1, V2, const V3, O1&)
+   */
+  template<class V1, class V2, class V3, class O1>
+  void seg_resample(Random& rng, V1 lws, V2 as, const V3 Ps, O1& s)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
   /**
@@ -129,12 +157,26 @@ public:
   void ancestorsPermute(Random& rng, const V1 lws, V2 as)
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc concept::Resampler::ancestors(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void ancestors(Random& rng, const V1 lws, V2 as, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * @copydoc concept::Resampler::offspring()
    */
   template<class V1, class V2>
   void offspring(Random& rng, const V1 lws, V2 os, const int P)
       throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::offspring(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void offspring(Random& rng, const V1 lws, V2 os, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
 private:
@@ -215,6 +257,18 @@ void bi::MetropolisResampler::cond_resample(Random& rng, const int ka,
   BI_ASSERT_MSG(false, "Not implemented");
 }
 
+template<class V1, class V2, class V3, class O1>
+void bi::MetropolisResampler::seg_resample(Random& rng, V1 lws, V2 as,
+    const V3 Ps, O1& s) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == as.size());
+
+  ancestors(rng, lws, as, Ps);
+  ResamplerHost::permute(as, Ps);
+  copy(as, s);
+  lws.clear();
+}
+
 template<class V1, class V2>
 void bi::MetropolisResampler::ancestors(Random& rng, const V1 lws, V2 as)
     throw (ParticleFilterDegeneratedException) {
@@ -231,6 +285,12 @@ void bi::MetropolisResampler::ancestorsPermute(Random& rng, const V1 lws,
   impl::ancestorsPermute(rng, lws, as, B);
 }
 
+template<class V1, class V2, class V3>
+void bi::MetropolisResampler::ancestors(Random& rng, const V1 lws, V2 as,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  MetropolisResamplerHost::ancestors(rng, lws, as, Ps, B);
+}
+
 template<class V1, class V2>
 void bi::MetropolisResampler::offspring(Random& rng, const V1 lws, V2 os,
     const int P) throw (ParticleFilterDegeneratedException) {
@@ -243,4 +303,15 @@ void bi::MetropolisResampler::offspring(Random& rng, const V1 lws, V2 os,
   ancestorsToOffspring(as, os);
 }
 
+template<class V1, class V2, class V3>
+void bi::MetropolisResampler::offspring(Random& rng, const V1 lws, V2 os,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == os.size());
+
+  typename sim_temp_vector<V2>::type as(lws.size());
+  ancestors(rng, lws, as, Ps);
+  ancestorsToOffspring(as, os);
+}
+
 #endif
@@ -40,6 +40,27 @@ public:
   static void ancestors(Random& rng, const V1 lws, V2 as,
       MultinomialPrecompute<ON_HOST>& pre)
           throw (ParticleFilterDegeneratedException);
+
+  /**
+   * Select ancestors for each of several groups.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights.
+   * @param[out] as Ancestors.
+   * @param Ps Group offsets.
+   * @param sort True to pre-sort weights, false otherwise.
+   *
+   * Variates are drawn in group order before the groups are processed, so
+   * that the result is that of separate calls to ancestors() for each group
+   * in turn, on a single thread.
+   */
+  template<class V1, class V2, class V3>
+  static void ancestors(Random& rng, const V1 lws, V2 as, const V3 Ps,
+      const bool sort) throw (ParticleFilterDegeneratedException);
 };
 
 /**
@@ -103,6 +124,13 @@ public:
   template<class V1, class V2, class V3, class O1>
   void resample(Random& rng, const int a, const V1 qlws, V2 lws, V3 as, O1& s)
       throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::seg_resample(Random&, V1, V2, const V3, O1&)
+   */
+  template<class V1, class V2, class V3, class O1>
+  void seg_resample(Random& rng, V1 lws, V2 as, const V3 Ps, O1& s)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
   /**
@@ -121,6 +149,13 @@ public:
       MultinomialPrecompute<L>& pre)
           throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc concept::Resampler::ancestors(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void ancestors(Random& rng, const V1 lws, V2 as, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
+
   template<class V1, class V2, Location L>
   void precompute(const V1 lws, const V2 as, MultinomialPrecompute<L>& pre);
 
@@ -130,6 +165,13 @@ public:
   template<class V1, class V2>
   void offspring(Random& rng, const V1 lws, V2 os, const int P)
       throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::offspring(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void offspring(Random& rng, const V1 lws, V2 os, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
 protected:
@@ -236,6 +278,18 @@ void bi::MultinomialResampler::resample(Random& rng, const int a,
   copy(as, s);
 }
 
+template<class V1, class V2, class V3, class O1>
+void bi::MultinomialResampler::seg_resample(Random& rng, V1 lws, V2 as,
+    const V3 Ps, O1& s) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == as.size());
+
+  ancestors(rng, lws, as, Ps);
+  ResamplerHost::permute(as, Ps);
+  copy(as, s);
+  lws.clear();
+}
+
 template<class V1, class V2>
 void bi::MultinomialResampler::ancestors(Random& rng, const V1 lws, V2 as)
     throw (ParticleFilterDegeneratedException) {
@@ -252,6 +306,12 @@ void bi::MultinomialResampler::ancestors(Random& rng, const V1 lws, V2 as,
   impl::ancestors(rng, lws, as, pre);
 }
 
+template<class V1, class V2, class V3>
+void bi::MultinomialResampler::ancestors(Random& rng, const V1 lws, V2 as,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  MultinomialResamplerHost::ancestors(rng, lws, as, Ps, sort);
+}
+
 template<class V1, class V2, bi::Location L>
 void bi::MultinomialResampler::precompute(const V1 lws, const V2 as,
     MultinomialPrecompute<L>& pre) {
@@ -287,4 +347,15 @@ void bi::MultinomialResampler::offspring(Random& rng, const V1 lws, V2 os,
   ancestorsToOffspring(as, os);
 }
 
+template<class V1, class V2, class V3>
+void bi::MultinomialResampler::offspring(Random& rng, const V1 lws, V2 os,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == os.size());
+
+  typename sim_temp_vector<V2>::type as(lws.size());
+  ancestors(rng, lws, as, Ps);
+  ancestorsToOffspring(as, os);
+}
+
 #endif
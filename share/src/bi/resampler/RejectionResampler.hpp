@@ -95,6 +95,13 @@ public:
   bool isTriggered(const V1 lws) const
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc isTriggered(const V1) const
+   */
+  template<class V1>
+  bool isTriggered(const V1 lws, const WeightStats& ws) const
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * @copydoc concept::Resampler::resample(Random&, V1, V2, O1&)
    */
@@ -186,6 +193,12 @@ bool bi::RejectionResampler::isTriggered(const V1 lws) const
   return true;
 }
 
+template<class V1>
+bool bi::RejectionResampler::isTriggered(const V1 lws,
+    const WeightStats& ws) const throw (ParticleFilterDegeneratedException) {
+  return true;
+}
+
 template<class V1, class V2, class O1>
 void bi::RejectionResampler::resample(Random& rng, V1 lws, V2 as, O1& s) {
   /* pre-condition */
@@ -8,6 +8,7 @@
 #ifndef BI_RESAMPLER_RESAMPLER_HPP
 #define BI_RESAMPLER_RESAMPLER_HPP
 
+#include "WeightStats.hpp"
 #include "../state/State.hpp"
 #include "../random/Random.hpp"
 #include "../misc/exception.hpp"
@@ -240,6 +241,18 @@ public:
   template<class V1>
   static void normalise(V1 lws);
 
+  /**
+   * Normalise log-weights after resampling, using cached statistics.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param lws Log-weights.
+   * @param[in,out] ws Statistics of @p lws. Recomputed first if not valid,
+   * and updated to reflect the normalisation.
+   */
+  template<class V1>
+  static void normalise(V1 lws, WeightStats& ws);
+
   /**
    * Is ESS-based condition triggered?
    *
@@ -251,6 +264,46 @@ public:
   bool isTriggered(const V1 lws) const
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * Is ESS-based condition triggered, using cached statistics?
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param lws Log-weights.
+   * @param ws Statistics of @p lws. If not valid, the ESS is computed from
+   * @p lws instead.
+   */
+  template<class V1>
+  bool isTriggered(const V1 lws, const WeightStats& ws) const
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * Number of particles ready for propagation after the last resample.
+   *
+   * @param P Number of particles.
+   *
+   * @return Number of particles, at the start of the state, that are ready
+   * for propagation. The remainder, if any, are not ready until finish() is
+   * called. This default implementation completes all copies within
+   * resample(), so that all @p P particles are ready.
+   */
+  int numReady(const int P) const;
+
+  /**
+   * Complete any copies left outstanding by the last resample.
+   *
+   * @tparam V1 Integral vector type.
+   * @tparam O1 Compatible with copy() function.
+   *
+   * @param[in,out] as Ancestry.
+   * @param[in,out] s State.
+   *
+   * Does nothing if no copies are outstanding, as is always the case for
+   * this default implementation.
+   */
+  template<class V1, class O1>
+  void finish(V1 as, O1& s);
+
   /**
    * Compute effective sample size (ESS) of log-weights.
    *
@@ -264,6 +317,16 @@ public:
   static typename V1::value_type ess(const V1 lws)
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * Compute effective sample size (ESS) from cached statistics.
+   *
+   * @param ws Statistics of log-weights.
+   *
+   * @return ESS.
+   */
+  static real ess(const WeightStats& ws)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * Compute sum of squared errors of ancestry.
    *
@@ -339,6 +402,74 @@ public:
    */
   template<class V1>
   static void permute(V1 as);
+
+  /**
+   * Compute ancestor vector from cumulative offspring vector, for each of
+   * several groups.
+   *
+   * @tparam V1 Integral vector type.
+   * @tparam V2 Integral vector type.
+   * @tparam V3 Integral vector type.
+   *
+   * @param Os Cumulative offspring, restarting from zero in each group.
+   * @param[out] as Ancestors.
+   * @param Ps Group offsets.
+   *
+   * Each group is as for cumulativeOffspringToAncestors(), with ancestors
+   * offset by the start of the group.
+   */
+  template<class V1, class V2, class V3>
+  static void cumulativeOffspringToAncestors(const V1 Os, V2 as,
+      const V3 Ps);
+
+  /**
+   * Compute already-permuted ancestor vector from cumulative offspring
+   * vector, for each of several groups.
+   *
+   * @tparam V1 Integral vector type.
+   * @tparam V2 Integral vector type.
+   * @tparam V3 Integral vector type.
+   *
+   * @param Os Cumulative offspring, restarting from zero in each group.
+   * @param[out] as Ancestors.
+   * @param Ps Group offsets.
+   *
+   * Each group is as for cumulativeOffspringToAncestorsPermute(), with
+   * ancestors offset by the start of the group.
+   */
+  template<class V1, class V2, class V3>
+  static void cumulativeOffspringToAncestorsPermute(const V1 Os, V2 as,
+      const V3 Ps);
+
+  /**
+   * Compute offspring vector from cumulative offspring vector, for each of
+   * several groups.
+   *
+   * @tparam V1 Integral vector type.
+   * @tparam V2 Integral vector type.
+   * @tparam V3 Integral vector type.
+   *
+   * @param Os Cumulative offspring, restarting from zero in each group.
+   * @param[out] os Offspring.
+   * @param Ps Group offsets.
+   */
+  template<class V1, class V2, class V3>
+  static void cumulativeOffspringToOffspring(const V1 Os, V2 os,
+      const V3 Ps);
+
+  /**
+   * Permute ancestors to permit in-place copy, for each of several groups.
+   *
+   * @tparam V1 Integral vector type.
+   * @tparam V2 Integral vector type.
+   *
+   * @param[in,out] as Ancestry. Ancestors must be within the same group.
+   * @param Ps Group offsets.
+   *
+   * Each group is as for permute().
+   */
+  template<class V1, class V2>
+  static void permute(V1 as, const V2 Ps);
 };
 
 /**
@@ -446,6 +577,15 @@ inline double bi::Resampler::getMaxLogWeight() const {
   return maxLogWeight;
 }
 
+inline int bi::Resampler::numReady(const int P) const {
+  return P;
+}
+
+template<class V1, class O1>
+inline void bi::Resampler::finish(V1 as, O1& s) {
+  //
+}
+
 template<class V1, class V2>
 void bi::Resampler::ancestorsToOffspring(const V1 as, V2 os) {
   typedef typename boost::mpl::if_c<V1::on_device,ResamplerGPU,ResamplerHost>::type impl;
@@ -541,12 +681,33 @@ void bi::Resampler::normalise(V1 lws) {
   addscal_elements(lws, bi::log(static_cast<T1>(lws.size())) - lW, lws);
 }
 
+template<class V1>
+void bi::Resampler::normalise(V1 lws, WeightStats& ws) {
+  typedef typename V1::value_type T1;
+  if (!ws.isValid()) {
+    ws.update(lws);
+  }
+  T1 c = bi::log(static_cast<T1>(lws.size())) - ws.logSumExp();
+  addscal_elements(lws, c, lws);
+  ws.shift(c);
+}
+
 template<class V1>
 bool bi::Resampler::isTriggered(const V1 lws) const
     throw (ParticleFilterDegeneratedException) {
   return essRel >= 1.0 || ess(lws) < essRel * lws.size();
 }
 
+template<class V1>
+bool bi::Resampler::isTriggered(const V1 lws, const WeightStats& ws) const
+    throw (ParticleFilterDegeneratedException) {
+  if (!ws.isValid()) {
+    return isTriggered(lws);
+  } else {
+    return essRel >= 1.0 || ess(ws) < essRel * lws.size();
+  }
+}
+
 template<class V1>
 typename V1::value_type bi::Resampler::ess(const V1 lws)
     throw (ParticleFilterDegeneratedException) {
@@ -559,6 +720,17 @@ typename V1::value_type bi::Resampler::ess(const V1 lws)
   }
 }
 
+inline real bi::Resampler::ess(const WeightStats& ws)
+    throw (ParticleFilterDegeneratedException) {
+  real result = ws.ess();
+
+  if (result > 0.0) {
+    return result;
+  } else {
+    throw ParticleFilterDegeneratedException();
+  }
+}
+
 template<class V1, class V2>
 typename V1::value_type bi::Resampler::error(const V1 lws, const V2 os) {
   real lW = logsumexp_reduce(lws);
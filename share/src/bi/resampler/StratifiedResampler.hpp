@@ -26,6 +26,27 @@ public:
    */
   template<class V1, class V2>
   static void op(Random& rng, const V1 Ws, V2 Os, const int n);
+
+  /**
+   * Compute cumulative offspring vector for each of several groups.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights.
+   * @param[out] Os Cumulative offspring, restarting from zero in each group.
+   * @param Ps Group offsets.
+   * @param sort True to pre-sort weights, false otherwise.
+   *
+   * Group @c g uses the step that the @c g th of separate calls to op()
+   * would, so that, with counter-based random number generation, the result
+   * is that of those separate calls.
+   */
+  template<class V1, class V2, class V3>
+  static void cumulativeOffspring(Random& rng, const V1 lws, V2 Os,
+      const V3 Ps, const bool sort) throw (ParticleFilterDegeneratedException);
 };
 
 /**
@@ -90,6 +111,13 @@ public:
   template<class V1, class V2, class O1>
   void cond_resample(Random& rng, const int ka, const int k, V1 lws, V2 as,
       O1& s) throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::seg_resample(Random&, V1, V2, const V3, O1&)
+   */
+  template<class V1, class V2, class V3, class O1>
+  void seg_resample(Random& rng, V1 lws, V2 as, const V3 Ps, O1& s)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
   /**
@@ -112,6 +140,13 @@ public:
   void offspring(Random& rng, const V1 lws, V2 os, const int n, bool sorted,
       V3 lws1, V4 ps, V3 Ws) throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc concept::Resampler::offspring(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void offspring(Random& rng, const V1 lws, V2 os, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * @copydoc concept::Resampler::cumulativeoOffspring
    */
@@ -144,6 +179,13 @@ public:
   void ancestors(Random& rng, const V1 lws, V2 as, int P, int ka, int k,
       bool sorted, V3 lws1, V4 ps, V3 Ws)
           throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::ancestors(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void ancestors(Random& rng, const V1 lws, V2 as, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
 protected:
@@ -268,6 +310,21 @@ void bi::StratifiedResampler::cond_resample(Random& rng, const int ka,
   lws.clear();
 }
 
+template<class V1, class V2, class V3, class O1>
+void bi::StratifiedResampler::seg_resample(Random& rng, V1 lws, V2 as,
+    const V3 Ps, O1& s) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == as.size());
+
+  const int P = lws.size();
+  typename sim_temp_vector<V2>::type Os(P);
+
+  StratifiedResamplerHost::cumulativeOffspring(rng, lws, Os, Ps, sort);
+  ResamplerHost::cumulativeOffspringToAncestorsPermute(Os, as, Ps);
+  lws.clear();
+  copy(as, s);
+}
+
 template<class V1, class V2>
 void bi::StratifiedResampler::offspring(Random& rng, const V1 lws, V2 os,
     const int n) throw (ParticleFilterDegeneratedException) {
@@ -508,6 +565,18 @@ void bi::StratifiedResampler::cumulativeOffspring(Random& rng, const V1 lws,
   }
 }
 
+template<class V1, class V2, class V3>
+void bi::StratifiedResampler::offspring(Random& rng, const V1 lws, V2 os,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == os.size());
+
+  typename sim_temp_vector<V2>::type Os(lws.size());
+
+  StratifiedResamplerHost::cumulativeOffspring(rng, lws, Os, Ps, sort);
+  ResamplerHost::cumulativeOffspringToOffspring(Os, os, Ps);
+}
+
 template<class V1, class V2>
 void bi::StratifiedResampler::ancestors(Random& rng, const V1 lws, V2 as)
     throw (ParticleFilterDegeneratedException) {
@@ -552,6 +621,18 @@ void bi::StratifiedResampler::ancestors(Random& rng, const V1 lws, V2 as,
   BI_ASSERT(*(as.begin() + k) == ka);
 }
 
+template<class V1, class V2, class V3>
+void bi::StratifiedResampler::ancestors(Random& rng, const V1 lws, V2 as,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(as.size() == lws.size());
+
+  typename sim_temp_vector<V2>::type Os(lws.size());
+
+  StratifiedResamplerHost::cumulativeOffspring(rng, lws, Os, Ps, sort);
+  ResamplerHost::cumulativeOffspringToAncestors(Os, as, Ps);
+}
+
 template<class V1, class V2>
 void bi::StratifiedResampler::op(Random& rng, const V1 Ws, V2 Os,
     const int n) {
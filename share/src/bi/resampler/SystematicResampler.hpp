@@ -54,6 +54,33 @@ struct resample_cumulative_offspring: public std::unary_function<T,int> {
   }
 };
 
+/**
+ * SystematicResampler implementation on host.
+ */
+class SystematicResamplerHost: public ResamplerHost {
+public:
+  /**
+   * Compute cumulative offspring vector for each of several groups.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights.
+   * @param[out] Os Cumulative offspring, restarting from zero in each group.
+   * @param Ps Group offsets.
+   * @param sort True to pre-sort weights, false otherwise.
+   *
+   * One offset into strata is drawn per group, in group order, so that the
+   * result is that of separate calls to cumulativeOffspring() for each
+   * group in turn.
+   */
+  template<class V1, class V2, class V3>
+  static void cumulativeOffspring(Random& rng, const V1 lws, V2 Os,
+      const V3 Ps, const bool sort) throw (ParticleFilterDegeneratedException);
+};
+
 /**
  * Systematic resampler for particle filter.
  *
@@ -104,6 +131,13 @@ public:
   template<class V1, class V2, class O1>
   void cond_resample(Random& rng, const int ka, const int k, V1 lws, V2 as,
       O1& s) throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::seg_resample(Random&, V1, V2, const V3, O1&)
+   */
+  template<class V1, class V2, class V3, class O1>
+  void seg_resample(Random& rng, V1 lws, V2 as, const V3 Ps, O1& s)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
   /**
@@ -126,6 +160,13 @@ public:
   void offspring(Random& rng, const V1 lws, V2 os, const int n, bool sorted,
       V3 lws1, V4 ps, V3 Ws) throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc concept::Resampler::offspring(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void offspring(Random& rng, const V1 lws, V2 os, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * @copydoc concept::Resampler::cumulativeoOffspring
    */
@@ -158,6 +199,13 @@ public:
   void ancestors(Random& rng, const V1 lws, V2 as, int P, int ka, int k,
       bool sorted, V3 lws1, V4 ps, V3 Ws)
           throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc concept::Resampler::ancestors(Random&, const V1, V2, const V3)
+   */
+  template<class V1, class V2, class V3>
+  void ancestors(Random& rng, const V1 lws, V2 as, const V3 Ps)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
 protected:
@@ -168,6 +216,8 @@ protected:
 };
 }
 
+#include "../host/resampler/SystematicResamplerHost.hpp"
+
 #include "../primitive/vector_primitive.hpp"
 #include "../primitive/matrix_primitive.hpp"
 #include "../misc/location.hpp"
@@ -264,6 +314,21 @@ void bi::SystematicResampler::cond_resample(Random& rng, const int ka,
   lws.clear();
 }
 
+template<class V1, class V2, class V3, class O1>
+void bi::SystematicResampler::seg_resample(Random& rng, V1 lws, V2 as,
+    const V3 Ps, O1& s) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == as.size());
+
+  const int P = lws.size();
+  typename sim_temp_vector<V2>::type Os(P);
+
+  SystematicResamplerHost::cumulativeOffspring(rng, lws, Os, Ps, sort);
+  ResamplerHost::cumulativeOffspringToAncestorsPermute(Os, as, Ps);
+  lws.clear();
+  copy(as, s);
+}
+
 template<class V1, class V2>
 void bi::SystematicResampler::offspring(Random& rng, const V1 lws, V2 os,
     const int n) throw (ParticleFilterDegeneratedException) {
@@ -525,6 +590,18 @@ void bi::SystematicResampler::cumulativeOffspring(Random& rng, const V1 lws,
   }
 }
 
+template<class V1, class V2, class V3>
+void bi::SystematicResampler::offspring(Random& rng, const V1 lws, V2 os,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == os.size());
+
+  typename sim_temp_vector<V2>::type Os(lws.size());
+
+  SystematicResamplerHost::cumulativeOffspring(rng, lws, Os, Ps, sort);
+  ResamplerHost::cumulativeOffspringToOffspring(Os, os, Ps);
+}
+
 template<class V1, class V2>
 void bi::SystematicResampler::ancestors(Random& rng, const V1 lws, V2 as)
     throw (ParticleFilterDegeneratedException) {
@@ -569,4 +646,16 @@ void bi::SystematicResampler::ancestors(Random& rng, const V1 lws, V2 as,
   BI_ASSERT(*(as.begin() + k) == ka);
 }
 
+template<class V1, class V2, class V3>
+void bi::SystematicResampler::ancestors(Random& rng, const V1 lws, V2 as,
+    const V3 Ps) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(as.size() == lws.size());
+
+  typename sim_temp_vector<V2>::type Os(lws.size());
+
+  SystematicResamplerHost::cumulativeOffspring(rng, lws, Os, Ps, sort);
+  ResamplerHost::cumulativeOffspringToAncestors(Os, as, Ps);
+}
+
 #endif
@@ -0,0 +1,229 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_RESAMPLER_WEIGHTSTATS_HPP
+#define BI_RESAMPLER_WEIGHTSTATS_HPP
+
+#include "../cuda/cuda.hpp"
+#include "../math/scalar.hpp"
+
+namespace bi {
+/**
+ * Summary statistics of log-weights.
+ *
+ * @ingroup method_resampler
+ *
+ * Holds the maximum log-weight \f$m\f$ and the sums
+ *
+ * \f[S_1 = \sum_i \exp(w_i - m)\,,\quad S_2 = \sum_i \exp(2(w_i - m))\,,\f]
+ *
+ * from which the log-sum-exp, the normalising constant and the effective
+ * sample size (ESS) follow without further passes over the log-weights.
+ * Statistics may be accumulated one log-weight at a time, and statistics of
+ * disjoint sets of log-weights merged, so that they can be computed in the
+ * same pass that computes the log-weights themselves. NaN log-weights do not
+ * contribute, as for logsumexp_reduce() and ess_reduce().
+ *
+ * The statistics are only as current as the log-weights from which they were
+ * computed. Code that modifies the log-weights by other means should call
+ * update(), shift() or invalidate() accordingly.
+ */
+class WeightStats {
+public:
+  /**
+   * Constructor. The statistics are those of an empty set of log-weights,
+   * and are not valid until the first call to update(), add() or merge().
+   */
+  CUDA_FUNC_BOTH WeightStats();
+
+  /**
+   * Are the statistics valid?
+   */
+  CUDA_FUNC_BOTH bool isValid() const;
+
+  /**
+   * Invalidate the statistics.
+   */
+  CUDA_FUNC_BOTH void invalidate();
+
+  /**
+   * Accumulate a log-weight.
+   *
+   * @param lw Log-weight.
+   */
+  CUDA_FUNC_BOTH void add(const real lw);
+
+  /**
+   * Merge statistics of a disjoint set of log-weights.
+   *
+   * @param o Statistics.
+   */
+  CUDA_FUNC_BOTH void merge(const WeightStats& o);
+
+  /**
+   * Adjust statistics after adding a constant to all log-weights.
+   *
+   * @param c The constant.
+   */
+  CUDA_FUNC_BOTH void shift(const real c);
+
+  /**
+   * Recompute statistics from log-weights, in a single pass.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param lws Log-weights.
+   */
+  template<class V1>
+  void update(const V1 lws);
+
+  /**
+   * Maximum log-weight.
+   */
+  CUDA_FUNC_BOTH real getMax() const;
+
+  /**
+   * Logarithm of the sum of weights.
+   */
+  CUDA_FUNC_BOTH real logSumExp() const;
+
+  /**
+   * Effective sample size (ESS).
+   */
+  CUDA_FUNC_BOTH real ess() const;
+
+private:
+  /**
+   * Maximum log-weight.
+   */
+  real mx;
+
+  /**
+   * Sum of weights, relative to maximum.
+   */
+  real sum1;
+
+  /**
+   * Sum of squared weights, relative to maximum.
+   */
+  real sum2;
+
+  /**
+   * Are the statistics valid?
+   */
+  bool valid;
+};
+
+/**
+ * @internal
+ *
+ * Statistics of a single log-weight.
+ */
+struct weight_stats_functor : public std::unary_function<real,WeightStats> {
+  CUDA_FUNC_BOTH WeightStats operator()(const real& lw) const {
+    WeightStats o;
+    o.add(lw);
+    return o;
+  }
+};
+
+/**
+ * @internal
+ *
+ * Merge of statistics.
+ */
+struct weight_stats_merge_functor : public std::binary_function<WeightStats,
+    WeightStats,WeightStats> {
+  CUDA_FUNC_BOTH WeightStats operator()(const WeightStats& o1,
+      const WeightStats& o2) const {
+    WeightStats o(o1);
+    o.merge(o2);
+    return o;
+  }
+};
+
+}
+
+#include "../math/function.hpp"
+
+#include "thrust/transform_reduce.h"
+
+inline bi::WeightStats::WeightStats() : mx(bi::log(BI_REAL(0.0))),
+    sum1(BI_REAL(0.0)), sum2(BI_REAL(0.0)), valid(false) {
+  //
+}
+
+inline bool bi::WeightStats::isValid() const {
+  return valid;
+}
+
+inline void bi::WeightStats::invalidate() {
+  valid = false;
+}
+
+inline void bi::WeightStats::add(const real lw) {
+  real e;
+
+  if (lw > mx) {
+    /* new maximum, rescale sums */
+    e = bi::exp(mx - lw);
+    sum1 = sum1*e + BI_REAL(1.0);
+    sum2 = sum2*e*e + BI_REAL(1.0);
+    mx = lw;
+  } else {
+    e = bi::nanexp(lw - mx);
+    sum1 += e;
+    sum2 += e*e;
+  }
+  valid = true;
+}
+
+inline void bi::WeightStats::merge(const WeightStats& o) {
+  real e;
+
+  if (o.mx > mx) {
+    e = bi::nanexp(mx - o.mx);
+    sum1 = sum1*e + o.sum1;
+    sum2 = sum2*e*e + o.sum2;
+    mx = o.mx;
+  } else {
+    e = bi::nanexp(o.mx - mx);
+    sum1 += o.sum1*e;
+    sum2 += o.sum2*e*e;
+  }
+  valid = valid || o.valid;
+}
+
+inline void bi::WeightStats::shift(const real c) {
+  mx += c;
+}
+
+template<class V1>
+void bi::WeightStats::update(const V1 lws) {
+  if (lws.inc() == 1) {
+    *this = thrust::transform_reduce(lws.fast_begin(), lws.fast_end(),
+        weight_stats_functor(), WeightStats(), weight_stats_merge_functor());
+  } else {
+    *this = thrust::transform_reduce(lws.begin(), lws.end(),
+        weight_stats_functor(), WeightStats(), weight_stats_merge_functor());
+  }
+  valid = true;
+}
+
+inline real bi::WeightStats::getMax() const {
+  return mx;
+}
+
+inline real bi::WeightStats::logSumExp() const {
+  return mx + bi::log(sum1);
+}
+
+inline real bi::WeightStats::ess() const {
+  return (sum1*sum1)/sum2;
+}
+
+#endif
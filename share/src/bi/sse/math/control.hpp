@@ -23,33 +23,57 @@ namespace bi {
 sse_real sse_if(const sse_real& mask, const sse_real& o1,
     const sse_real& o2);
 
+/**
+ * Conjunction of masks.
+ */
+sse_real sse_and(const sse_real& mask1, const sse_real& mask2);
+
 /**
  * Any.
  *
  * @return True if any mask components are true, false otherwise.
- *
- * @todo Is there a reduction intrinsic for this in SSE3?
  */
 bool sse_any(const sse_real& mask);
 
+/**
+ * All.
+ *
+ * @return True if all mask components are true, false otherwise.
+ */
+bool sse_all(const sse_real& mask);
+
+/**
+ * Maximum of components.
+ */
+real sse_max(const sse_real& x);
+
 }
 
 inline bi::sse_real bi::sse_if(const bi::sse_real& mask,
     const bi::sse_real& o1, const bi::sse_real& o2) {
-  return BI_SSE_ADD_P(BI_SSE_AND_P(mask.packed, o1.packed),
+  return BI_SSE_OR_P(BI_SSE_AND_P(mask.packed, o1.packed),
       BI_SSE_ANDNOT_P(mask.packed, o2.packed));
 }
 
+inline bi::sse_real bi::sse_and(const bi::sse_real& mask1,
+    const bi::sse_real& mask2) {
+  return BI_SSE_AND_P(mask1.packed, mask2.packed);
+}
+
 inline bool bi::sse_any(const bi::sse_real& mask) {
-  bool result = false;
-  #ifdef ENABLE_SINGLE
-  CUDA_ALIGN(16) int x[BI_SSE_SIZE] BI_ALIGN(16);
-  #else
-  CUDA_ALIGN(16) long x[BI_SSE_SIZE] BI_ALIGN(16);
-  #endif
-  BI_SSE_STORE_P(reinterpret_cast<real*>(x), mask.packed);
-  for (int i = 0; !result && i < BI_SSE_SIZE; ++i) {
-    result = result || x[i];
+  return BI_SSE_MOVEMASK_P(mask.packed) != 0;
+}
+
+inline bool bi::sse_all(const bi::sse_real& mask) {
+  return BI_SSE_MOVEMASK_P(mask.packed) == (1 << BI_SSE_SIZE) - 1;
+}
+
+inline real bi::sse_max(const bi::sse_real& x) {
+  real result = x.unpacked[0];
+  for (int i = 1; i < BI_SSE_SIZE; ++i) {
+    if (x.unpacked[i] > result) {
+      result = x.unpacked[i];
+    }
   }
   return result;
 }
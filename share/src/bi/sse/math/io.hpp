@@ -22,12 +22,10 @@
 std::ostream& operator<<(std::ostream& stream, const bi::sse_real& x);
 
 inline std::ostream& operator<<(std::ostream& stream, const bi::sse_real& x) {
-  stream << '[' << x.unpacked.a;
-  stream << ',' << x.unpacked.b;
-  #ifdef ENABLE_SINGLE
-  stream << ',' << x.unpacked.c;
-  stream << ',' << x.unpacked.d;
-  #endif
+  stream << '[' << x.unpacked[0];
+  for (int i = 1; i < BI_SSE_SIZE; ++i) {
+    stream << ',' << x.unpacked[i];
+  }
   stream << ']';
 
   return stream;
@@ -1,7 +1,8 @@
 /**
  * @file
  *
- * Types and operators for Streaming SIMD Extensions (SSE).
+ * Types and operators for Streaming SIMD Extensions (SSE), and for the
+ * wider Advanced Vector Extensions (AVX, AVX-512) under the same names.
  *
  * @author Lawrence Murray <lawrence.murray@csiro.au>
  * $Rev$
@@ -13,23 +14,163 @@
 #include "../../math/scalar.hpp"
 #include "../../misc/compile.hpp"
 
+#if defined(ENABLE_AVX512) || defined(ENABLE_AVX)
+#include <immintrin.h>
+#else
 #include <pmmintrin.h>
+#endif
 
 /**
  * @def BI_SSE_SIZE
  *
  * Number of packed elements in an sse_real variable.
+ *
+ * This is 128 bits' worth by default, 256 bits' worth when compiled with
+ * @c ENABLE_AVX, and 512 bits' worth when compiled with @c ENABLE_AVX512.
+ * The names of the sse_real type and BI_SSE_* macros are retained for all
+ * widths.
  */
+#if defined(ENABLE_AVX512)
+#ifdef ENABLE_SINGLE
+#define BI_SSE_SIZE 16
+#else
+#define BI_SSE_SIZE 8
+#endif
+#elif defined(ENABLE_AVX)
+#ifdef ENABLE_SINGLE
+#define BI_SSE_SIZE 8
+#else
+#define BI_SSE_SIZE 4
+#endif
+#else
 #ifdef ENABLE_SINGLE
 #define BI_SSE_SIZE 4
 #else
 #define BI_SSE_SIZE 2
 #endif
+#endif
 
 /*
- * Function aliases.
+ * Function aliases. The scalar (_S), shuffle and horizontal operations are
+ * available for the 128-bit types only. BI_SSE_SLLI_P and BI_SSE_SRLI_P
+ * shift the bits of each element as an integer of the same width.
  */
+#if defined(ENABLE_AVX512)
+#ifdef ENABLE_SINGLE
+#define BI_SSE_TYPE __m512
+#define BI_SSE_ADD_P _mm512_add_ps
+#define BI_SSE_SUB_P _mm512_sub_ps
+#define BI_SSE_MUL_P _mm512_mul_ps
+#define BI_SSE_DIV_P _mm512_div_ps
+#define BI_SSE_SQRT_P _mm512_sqrt_ps
+#define BI_SSE_MAX_P _mm512_max_ps
+#define BI_SSE_MIN_P _mm512_min_ps
+#define BI_SSE_LOAD_P _mm512_load_ps
+#define BI_SSE_LOAD1_P(x) _mm512_set1_ps(*(x))
+#define BI_SSE_STORE_P _mm512_store_ps
+#define BI_SSE_SET_P _mm512_set_ps
+#define BI_SSE_SET1_P _mm512_set1_ps
+#define BI_SSE_MASK_P(k) _mm512_castsi512_ps(_mm512_maskz_set1_epi32(k, -1))
+#define BI_SSE_CMPEQ_P(x, y) BI_SSE_MASK_P(_mm512_cmp_ps_mask(x, y, _CMP_EQ_OQ))
+#define BI_SSE_CMPLT_P(x, y) BI_SSE_MASK_P(_mm512_cmp_ps_mask(x, y, _CMP_LT_OS))
+#define BI_SSE_CMPLE_P(x, y) BI_SSE_MASK_P(_mm512_cmp_ps_mask(x, y, _CMP_LE_OS))
+#define BI_SSE_CMPGT_P(x, y) BI_SSE_MASK_P(_mm512_cmp_ps_mask(x, y, _CMP_GT_OS))
+#define BI_SSE_CMPGE_P(x, y) BI_SSE_MASK_P(_mm512_cmp_ps_mask(x, y, _CMP_GE_OS))
+#define BI_SSE_CMPNEQ_P(x, y) BI_SSE_MASK_P(_mm512_cmp_ps_mask(x, y, _CMP_NEQ_UQ))
+#define BI_SSE_AND_P(x, y) _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(x), _mm512_castps_si512(y)))
+#define BI_SSE_ANDNOT_P(x, y) _mm512_castsi512_ps(_mm512_andnot_si512(_mm512_castps_si512(x), _mm512_castps_si512(y)))
+#define BI_SSE_XOR_P(x, y) _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(x), _mm512_castps_si512(y)))
+#define BI_SSE_OR_P(x, y) _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(x), _mm512_castps_si512(y)))
+#define BI_SSE_SLLI_P(x, n) _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_castps_si512(x), n))
+#define BI_SSE_SRLI_P(x, n) _mm512_castsi512_ps(_mm512_srli_epi32(_mm512_castps_si512(x), n))
+#define BI_SSE_MOVEMASK_P(x) static_cast<int>(_mm512_test_epi32_mask(_mm512_castps_si512(x), _mm512_castps_si512(x)))
+#else
+#define BI_SSE_TYPE __m512d
+#define BI_SSE_ADD_P _mm512_add_pd
+#define BI_SSE_SUB_P _mm512_sub_pd
+#define BI_SSE_MUL_P _mm512_mul_pd
+#define BI_SSE_DIV_P _mm512_div_pd
+#define BI_SSE_SQRT_P _mm512_sqrt_pd
+#define BI_SSE_MAX_P _mm512_max_pd
+#define BI_SSE_MIN_P _mm512_min_pd
+#define BI_SSE_LOAD_P _mm512_load_pd
+#define BI_SSE_LOAD1_P(x) _mm512_set1_pd(*(x))
+#define BI_SSE_STORE_P _mm512_store_pd
+#define BI_SSE_SET_P _mm512_set_pd
+#define BI_SSE_SET1_P _mm512_set1_pd
+#define BI_SSE_MASK_P(k) _mm512_castsi512_pd(_mm512_maskz_set1_epi64(k, -1))
+#define BI_SSE_CMPEQ_P(x, y) BI_SSE_MASK_P(_mm512_cmp_pd_mask(x, y, _CMP_EQ_OQ))
+#define BI_SSE_CMPLT_P(x, y) BI_SSE_MASK_P(_mm512_cmp_pd_mask(x, y, _CMP_LT_OS))
+#define BI_SSE_CMPLE_P(x, y) BI_SSE_MASK_P(_mm512_cmp_pd_mask(x, y, _CMP_LE_OS))
+#define BI_SSE_CMPGT_P(x, y) BI_SSE_MASK_P(_mm512_cmp_pd_mask(x, y, _CMP_GT_OS))
+#define BI_SSE_CMPGE_P(x, y) BI_SSE_MASK_P(_mm512_cmp_pd_mask(x, y, _CMP_GE_OS))
+#define BI_SSE_CMPNEQ_P(x, y) BI_SSE_MASK_P(_mm512_cmp_pd_mask(x, y, _CMP_NEQ_UQ))
+#define BI_SSE_AND_P(x, y) _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(x), _mm512_castpd_si512(y)))
+#define BI_SSE_ANDNOT_P(x, y) _mm512_castsi512_pd(_mm512_andnot_si512(_mm512_castpd_si512(x), _mm512_castpd_si512(y)))
+#define BI_SSE_XOR_P(x, y) _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(x), _mm512_castpd_si512(y)))
+#define BI_SSE_OR_P(x, y) _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(x), _mm512_castpd_si512(y)))
+#define BI_SSE_SLLI_P(x, n) _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(x), n))
+#define BI_SSE_SRLI_P(x, n) _mm512_castsi512_pd(_mm512_srli_epi64(_mm512_castpd_si512(x), n))
+#define BI_SSE_MOVEMASK_P(x) static_cast<int>(_mm512_test_epi64_mask(_mm512_castpd_si512(x), _mm512_castpd_si512(x)))
+#endif
+#elif defined(ENABLE_AVX)
 #ifdef ENABLE_SINGLE
+#define BI_SSE_TYPE __m256
+#define BI_SSE_ADD_P _mm256_add_ps
+#define BI_SSE_SUB_P _mm256_sub_ps
+#define BI_SSE_MUL_P _mm256_mul_ps
+#define BI_SSE_DIV_P _mm256_div_ps
+#define BI_SSE_SQRT_P _mm256_sqrt_ps
+#define BI_SSE_MAX_P _mm256_max_ps
+#define BI_SSE_MIN_P _mm256_min_ps
+#define BI_SSE_LOAD_P _mm256_load_ps
+#define BI_SSE_LOAD1_P _mm256_broadcast_ss
+#define BI_SSE_STORE_P _mm256_store_ps
+#define BI_SSE_SET_P _mm256_set_ps
+#define BI_SSE_SET1_P _mm256_set1_ps
+#define BI_SSE_CMPEQ_P(x, y) _mm256_cmp_ps(x, y, _CMP_EQ_OQ)
+#define BI_SSE_CMPLT_P(x, y) _mm256_cmp_ps(x, y, _CMP_LT_OS)
+#define BI_SSE_CMPLE_P(x, y) _mm256_cmp_ps(x, y, _CMP_LE_OS)
+#define BI_SSE_CMPGT_P(x, y) _mm256_cmp_ps(x, y, _CMP_GT_OS)
+#define BI_SSE_CMPGE_P(x, y) _mm256_cmp_ps(x, y, _CMP_GE_OS)
+#define BI_SSE_CMPNEQ_P(x, y) _mm256_cmp_ps(x, y, _CMP_NEQ_UQ)
+#define BI_SSE_AND_P _mm256_and_ps
+#define BI_SSE_ANDNOT_P _mm256_andnot_ps
+#define BI_SSE_XOR_P _mm256_xor_ps
+#define BI_SSE_OR_P _mm256_or_ps
+#define BI_SSE_SLLI_P(x, n) _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_castps_si256(x), n))
+#define BI_SSE_SRLI_P(x, n) _mm256_castsi256_ps(_mm256_srli_epi32(_mm256_castps_si256(x), n))
+#define BI_SSE_MOVEMASK_P _mm256_movemask_ps
+#else
+#define BI_SSE_TYPE __m256d
+#define BI_SSE_ADD_P _mm256_add_pd
+#define BI_SSE_SUB_P _mm256_sub_pd
+#define BI_SSE_MUL_P _mm256_mul_pd
+#define BI_SSE_DIV_P _mm256_div_pd
+#define BI_SSE_SQRT_P _mm256_sqrt_pd
+#define BI_SSE_MAX_P _mm256_max_pd
+#define BI_SSE_MIN_P _mm256_min_pd
+#define BI_SSE_LOAD_P _mm256_load_pd
+#define BI_SSE_LOAD1_P _mm256_broadcast_sd
+#define BI_SSE_STORE_P _mm256_store_pd
+#define BI_SSE_SET_P _mm256_set_pd
+#define BI_SSE_SET1_P _mm256_set1_pd
+#define BI_SSE_CMPEQ_P(x, y) _mm256_cmp_pd(x, y, _CMP_EQ_OQ)
+#define BI_SSE_CMPLT_P(x, y) _mm256_cmp_pd(x, y, _CMP_LT_OS)
+#define BI_SSE_CMPLE_P(x, y) _mm256_cmp_pd(x, y, _CMP_LE_OS)
+#define BI_SSE_CMPGT_P(x, y) _mm256_cmp_pd(x, y, _CMP_GT_OS)
+#define BI_SSE_CMPGE_P(x, y) _mm256_cmp_pd(x, y, _CMP_GE_OS)
+#define BI_SSE_CMPNEQ_P(x, y) _mm256_cmp_pd(x, y, _CMP_NEQ_UQ)
+#define BI_SSE_AND_P _mm256_and_pd
+#define BI_SSE_ANDNOT_P _mm256_andnot_pd
+#define BI_SSE_XOR_P _mm256_xor_pd
+#define BI_SSE_OR_P _mm256_or_pd
+#define BI_SSE_SLLI_P(x, n) _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(x), n))
+#define BI_SSE_SRLI_P(x, n) _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(x), n))
+#define BI_SSE_MOVEMASK_P _mm256_movemask_pd
+#endif
+#elif defined(ENABLE_SINGLE)
+#define BI_SSE_TYPE __m128
 #define BI_SSE_ADD_S _mm_add_ss
 #define BI_SSE_ADD_P _mm_add_ps
 #define BI_SSE_SUB_S _mm_sub_ss
@@ -68,9 +209,14 @@
 #define BI_SSE_AND_P _mm_and_ps
 #define BI_SSE_ANDNOT_P _mm_andnot_ps
 #define BI_SSE_XOR_P _mm_xor_ps
+#define BI_SSE_OR_P _mm_or_ps
+#define BI_SSE_SLLI_P(x, n) _mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128(x), n))
+#define BI_SSE_SRLI_P(x, n) _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(x), n))
 #define BI_SSE_HADD_P _mm_hadd_ps
+#define BI_SSE_MOVEMASK_P _mm_movemask_ps
 #define BI_SSE_ROTATE_LEFT(x) BI_SSE_SHUFFLE_P(x, x, _MM_SHUFFLE(0,3,2,1))
 #else
+#define BI_SSE_TYPE __m128d
 #define BI_SSE_ADD_S _mm_add_sd
 #define BI_SSE_ADD_P _mm_add_pd
 #define BI_SSE_SUB_S _mm_sub_sd
@@ -111,57 +257,34 @@
 #define BI_SSE_AND_P _mm_and_pd
 #define BI_SSE_ANDNOT_P _mm_andnot_pd
 #define BI_SSE_XOR_P _mm_xor_pd
+#define BI_SSE_OR_P _mm_or_pd
+#define BI_SSE_SLLI_P(x, n) _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(x), n))
+#define BI_SSE_SRLI_P(x, n) _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(x), n))
 #define BI_SSE_HADD_P _mm_hadd_pd // horizontal add
+#define BI_SSE_MOVEMASK_P _mm_movemask_pd
 #define BI_SSE_ROTATE_LEFT(x) BI_SSE_SHUFFLE_P(x, x, _MM_SHUFFLE(1,0,3,2))
 #endif
 #define BI_SSE_PREFETCH _mm_prefetch
 
 /**
- * 128-bit packed floating point type.
+ * Packed floating point type.
  */
 namespace bi {
   union sse_real {
-    #ifdef ENABLE_SINGLE
-    struct {
-      real a, b, c, d;
-    } unpacked;
-    __m128 packed;
-
-    sse_real(const real a, const real b, const real c, const real d) {
-      unpacked.a = a;
-      unpacked.b = b;
-      unpacked.c = c;
-      unpacked.d = d;
-    }
+    /**
+     * Elements.
+     */
+    real unpacked[BI_SSE_SIZE];
 
-    sse_real(const __m128 x) : packed(x) {
-      //
-    }
-    #else
-    struct {
-      real a, b;
-    } unpacked;
-    __m128d packed;
-
-    sse_real(const real a, const real b) {
-      unpacked.a = a;
-      unpacked.b = b;
-    }
+    /**
+     * Packed elements.
+     */
+    BI_SSE_TYPE packed;
 
-    sse_real(const __m128d x) : packed(x) {
+    sse_real(const BI_SSE_TYPE x) : packed(x) {
       //
     }
 
-    real& operator[](const int i) {
-      if (i == 0) {
-        return unpacked.a;
-      } else {
-        return unpacked.b;
-      }
-    }
-
-    #endif
-
     sse_real() {
       //
     }
@@ -174,6 +297,14 @@ namespace bi {
       packed = BI_SSE_SET1_P(a);
       return *this;
     }
+
+    real& operator[](const int i) {
+      return unpacked[i];
+    }
+
+    const real& operator[](const int i) const {
+      return unpacked[i];
+    }
   };
 
 sse_real& operator+=(sse_real& o1, const sse_real& o2);
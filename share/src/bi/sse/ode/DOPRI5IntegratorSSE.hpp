@@ -8,17 +8,35 @@
 #ifndef BI_SSE_ODE_DOPRI5INTEGRATORSSE_HPP
 #define BI_SSE_ODE_DOPRI5INTEGRATORSSE_HPP
 
+#include "../../ode/IntegratorConfig.hpp"
+
 namespace bi {
 /**
  * @copydoc DOPRI5Integrator
  */
-template<class B, class S, class T1>
+template<class B, class S, class XH, class XT, class T1>
 class DOPRI5IntegratorSSE {
 public:
   /**
    * @copydoc DOPRI5Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Update with a common step size for the trajectories of each sse_real,
+   * chosen for the largest error among them.
+   */
+  static void updateLockstep(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+  /**
+   * Update with a separate step size for each trajectory of each sse_real.
+   * Trajectories that reach @p t2 sit idle until the rest do also.
+   */
+  static void updateComponentwise(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
@@ -26,14 +44,23 @@ public:
 #include "../math/function.hpp"
 #include "../math/control.hpp"
 #include "../../host/ode/DOPRI5VisitorHost.hpp"
-#include "../../host/ode/IntegratorConstants.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
 
-template<class B, class S, class T1>
-void bi::DOPRI5IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+template<class B, class S, class XH, class XT, class T1>
+void bi::DOPRI5IntegratorSSE<B,S,XH,XT,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
+  if (cfg.lockstep) {
+    updateLockstep(cfg, t1, t2, s);
+  } else {
+    updateComponentwise(cfg, t1, t2, s);
+  }
+}
+
+template<class B, class S, class XH, class XT, class T1>
+void bi::DOPRI5IntegratorSSE<B,S,XH,XT,T1>::updateLockstep(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
@@ -58,25 +85,40 @@ void bi::DOPRI5IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
     vector_reference_type k7(buf + 9*N, N);
 
     sse_real e, e2;
-    real t, h, logfacold, logfac11, fac, e2max;
-    int n, id, p;
+    real t, h, hn, logfacold, logfac11, fac, e2max;
+    int n, id, j, p;
     bool k1in;
     PX pax;
 
     #pragma omp for
     for (p = 0; p < P; p += BI_SSE_SIZE) {
       t = t1;
-      h = h_h0;
+
+      /* resume with step size of last call, if it stopped at t1, taking the
+       * smallest among trajectories */
+      h = s.template getVar<XH>(p, 0);
+      for (j = 0; j < BI_SSE_SIZE; ++j) {
+        if (s.template getVar<XT>(p + j, 0) != t1) {
+          h = BI_REAL(0.0);
+        }
+        h = bi::min(h, s.template getVar<XH>(p + j, 0));
+      }
+      if (h <= BI_REAL(0.0)) {
+        h = cfg.h0;
+      }
+      hn = h;
+
       logfacold = bi::log(BI_REAL(1.0e-4));
       k1in = false;
       n = 0;
       sse_host_load<B,S>(s, p, x0);
 
       /* integrate */
-      while (t < t2 && n < h_nsteps) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+      while (t < t2 && n < cfg.nsteps) {
+        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*cfg.uround) {
           // step size too small
         }
+        hn = h; // step size to carry, before truncation at t2
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
           h = t2 - t;
           if (h <= BI_REAL(0.0)) {
@@ -103,6 +145,7 @@ void bi::DOPRI5IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
         sse_host_store<B,S>(s, p, x5);
 
         Visitor::stage6(t, h, s, p, pax, x0.buf(), x6.buf(), err.buf());
+        sse_host_store<B,S>(s, p, x6);
 
         /* compute error */
         Visitor::stageErr(t, h, s, p, pax, x0.buf(), x6.buf(), k7.buf(), err.buf());
@@ -110,14 +153,10 @@ void bi::DOPRI5IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
         /* determine largest error among trajectories */
         e2 = BI_REAL(0.0);
         for (id = 0; id < N; ++id) {
-          e = err[id]*h/(bi::max(bi::abs(x0(id)), bi::abs(x6(id)))*h_rtoler + h_atoler);
+          e = err[id]*h/(bi::max(bi::abs(x0(id)), bi::abs(x6(id)))*cfg.rtoler + cfg.atoler);
           e2 += e*e;
         }
-        #ifdef ENABLE_SINGLE
-        e2max = bi::max(bi::max(e2.unpacked.a, e2.unpacked.b), bi::max(e2.unpacked.c, e2.unpacked.d));
-        #else
-        e2max = bi::max(e2.unpacked.a, e2.unpacked.b);
-        #endif
+        e2max = sse_max(e2);
         e2max /= N;
 
         if (e2max <= BI_REAL(1.0)) {
@@ -129,22 +168,152 @@ void bi::DOPRI5IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
         sse_host_store<B,S>(s, p, x0);
 
         /* compute next step size */
-        if (t < t2) {
-          logfac11 = h_expo*bi::log(e2max);
-          if (e2max > BI_REAL(1.0)) {
-            /* step was rejected */
-            h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
-          } else {
-            /* step was accepted */
-            fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11); // Lund-stabilization
-            fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
-            h *= fac;
-            logfacold = BI_REAL(0.5)*bi::log(bi::max(e2max, BI_REAL(1.0e-8)));
+        logfac11 = cfg.expo*bi::log(e2max);
+        if (e2max > BI_REAL(1.0)) {
+          /* step was rejected */
+          h *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11));
+        } else {
+          /* step was accepted */
+          fac = bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11); // Lund-stabilization
+          fac = bi::min(cfg.facr, bi::max(cfg.facl, fac)); // bound
+          h *= fac;
+          logfacold = BI_REAL(0.5)*bi::log(bi::max(e2max, BI_REAL(1.0e-8)));
+          if (t >= t2) {
+            /* finished, carry the larger of the step sizes proposed before
+             * truncation at t2 and after the last step */
+            hn = bi::max(hn, h);
           }
         }
 
         ++n;
       }
+
+      for (j = 0; j < BI_SSE_SIZE; ++j) {
+        s.template getVar<XH>(p + j, 0) = hn;
+        s.template getVar<XT>(p + j, 0) = t;
+      }
+    }
+  }
+}
+
+template<class B, class S, class XH, class XT, class T1>
+void bi::DOPRI5IntegratorSSE<B,S,XH,XT,T1>::updateComponentwise(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  typedef host_vector_reference<sse_real> vector_reference_type;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef DOPRI5VisitorHost<B,S,S,sse_real,PX,sse_real> Visitor;
+  static const int N = block_size<S>::value;
+  const int P = s.size();
+
+  #pragma omp parallel
+  {
+    sse_real buf[10*N];
+    vector_reference_type x0(buf, N);
+    vector_reference_type x1(buf + N, N);
+    vector_reference_type x2(buf + 2*N, N);
+    vector_reference_type x3(buf + 3*N, N);
+    vector_reference_type x4(buf + 4*N, N);
+    vector_reference_type x5(buf + 5*N, N);
+    vector_reference_type x6(buf + 6*N, N);
+    vector_reference_type err(buf + 7*N, N);
+    vector_reference_type k1(buf + 8*N, N);
+    vector_reference_type k7(buf + 9*N, N);
+
+    sse_real e, e2, t, h, hn, n, logfacold, logfac11, fac, active, accept;
+    int id, j, p;
+    bool k1in;
+    PX pax;
+
+    #pragma omp for
+    for (p = 0; p < P; p += BI_SSE_SIZE) {
+      t = t1;
+      h = cfg.h0;
+      for (j = 0; j < BI_SSE_SIZE; ++j) {
+        if (s.template getVar<XT>(p + j, 0) == t1 &&
+            s.template getVar<XH>(p + j, 0) > BI_REAL(0.0)) {
+          /* resume with step size of last call, which stopped at t1 */
+          h[j] = s.template getVar<XH>(p + j, 0);
+        }
+      }
+      hn = h;
+      logfacold = bi::log(BI_REAL(1.0e-4));
+      k1in = false;
+      n = BI_REAL(0.0);
+      active = t < t2;
+      sse_host_load<B,S>(s, p, x0);
+
+      /* integrate */
+      while (sse_any(active)) {
+        /* step no further than t2, and not at all once finished */
+        hn = sse_if(active, h, hn); // step size to carry, before truncation
+        h = sse_if(t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0), t2 - t, h);
+        h = sse_if(active, h, BI_REAL(0.0));
+
+        /* stages */
+        Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), k1.buf(), err.buf(), k1in);
+        k1in = true; // can reuse from previous iteration in future
+        sse_host_store<B,S>(s, p, x1);
+
+        Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+        sse_host_store<B,S>(s, p, x2);
+
+        Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+        sse_host_store<B,S>(s, p, x3);
+
+        Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+        sse_host_store<B,S>(s, p, x4);
+
+        Visitor::stage5(t, h, s, p, pax, x0.buf(), x5.buf(), x6.buf(), err.buf());
+        sse_host_store<B,S>(s, p, x5);
+
+        Visitor::stage6(t, h, s, p, pax, x0.buf(), x6.buf(), err.buf());
+        sse_host_store<B,S>(s, p, x6);
+
+        /* compute error */
+        Visitor::stageErr(t, h, s, p, pax, x0.buf(), x6.buf(), k7.buf(), err.buf());
+
+        /* determine error of each trajectory */
+        e2 = BI_REAL(0.0);
+        for (id = 0; id < N; ++id) {
+          e = err[id]*h/(bi::max(bi::abs(x0(id)), bi::abs(x6(id)))*cfg.rtoler + cfg.atoler);
+          e2 += e*e;
+        }
+        e2 /= N;
+
+        /* accept or reject each trajectory, rejected trajectories keeping
+         * k1 for reuse */
+        accept = sse_and(active, e2 <= BI_REAL(1.0));
+        t = sse_if(accept, t + h, t);
+        if (sse_all(accept)) {
+          x0.swap(x6);
+          k1.swap(k7);
+        } else {
+          for (id = 0; id < N; ++id) {
+            x0(id) = sse_if(accept, x6(id), x0(id));
+            k1(id) = sse_if(accept, k7(id), k1(id));
+          }
+        }
+        sse_host_store<B,S>(s, p, x0);
+
+        /* compute next step size */
+        logfac11 = cfg.expo*bi::log(e2);
+        fac = bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11); // Lund-stabilization
+        fac = bi::min(cfg.facr, bi::max(cfg.facl, fac)); // bound
+        h = sse_if(accept, h*fac, h*bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11)));
+        logfacold = sse_if(accept, BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8))), logfacold);
+        hn = sse_if(sse_and(accept, t >= t2), bi::max(hn, h), hn);
+
+        n = sse_if(active, n + BI_REAL(1.0), n);
+        active = sse_and(t < t2, n < BI_REAL(cfg.nsteps));
+      }
+
+      for (j = 0; j < BI_SSE_SIZE; ++j) {
+        s.template getVar<XH>(p + j, 0) = hn[j];
+        s.template getVar<XT>(p + j, 0) = t[j];
+      }
     }
   }
 }
@@ -8,6 +8,8 @@
 #ifndef BI_SSE_ODE_RK43INTEGRATORSSE_HPP
 #define BI_SSE_ODE_RK43INTEGRATORSSE_HPP
 
+#include "../../ode/IntegratorConfig.hpp"
+
 namespace bi {
 /**
  * @copydoc RK43Integrator
@@ -18,7 +20,23 @@ public:
   /**
    * @copydoc RK43Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Update with a common step size for the trajectories of each sse_real,
+   * chosen for the largest error among them.
+   */
+  static void updateLockstep(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
+
+  /**
+   * Update with a separate step size for each trajectory of each sse_real.
+   * Trajectories that reach @p t2 sit idle until the rest do also.
+   */
+  static void updateComponentwise(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
@@ -26,14 +44,23 @@ public:
 #include "../math/function.hpp"
 #include "../math/control.hpp"
 #include "../../host/ode/RK43VisitorHost.hpp"
-#include "../../host/ode/IntegratorConstants.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
 
 template<class B, class S, class T1>
-void bi::RK43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+void bi::RK43IntegratorSSE<B,S,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
+  if (cfg.lockstep) {
+    updateLockstep(cfg, t1, t2, s);
+  } else {
+    updateComponentwise(cfg, t1, t2, s);
+  }
+}
+
+template<class B, class S, class T1>
+void bi::RK43IntegratorSSE<B,S,T1>::updateLockstep(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
@@ -59,15 +86,15 @@ void bi::RK43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
     #pragma omp for
     for (p = 0; p < P; p += BI_SSE_SIZE) {
       t = t1;
-      h = h_h0;
+      h = cfg.h0;
       logfacold = bi::log(BI_REAL(1.0e-4));
       n = 0;
       sse_host_load<B,S>(s, p, old);
       r1 = old;
 
       /* integrate */
-      while (t < t2 && n < h_nsteps) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+      while (t < t2 && n < cfg.nsteps) {
+        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*cfg.uround) {
           // step size too small
         }
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
@@ -97,14 +124,10 @@ void bi::RK43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
         /* determine largest error among trajectories */
         e2 = BI_REAL(0.0);
         for (id = 0; id < N; ++id) {
-          e = err(id)*h/(bi::max(bi::abs(old(id)), bi::abs(r1(id)))*h_rtoler + h_atoler);
+          e = err(id)*h/(bi::max(bi::abs(old(id)), bi::abs(r1(id)))*cfg.rtoler + cfg.atoler);
           e2 += e*e;
         }
-        #ifdef ENABLE_SINGLE
-        e2max = bi::max(bi::max(e2.unpacked.a, e2.unpacked.b), bi::max(e2.unpacked.c, e2.unpacked.d));
-        #else
-        e2max = bi::max(e2.unpacked.a, e2.unpacked.b);
-        #endif
+        e2max = sse_max(e2);
         e2max /= N;
 
         if (e2max <= BI_REAL(1.0)) {
@@ -121,14 +144,14 @@ void bi::RK43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
 
         /* compute next step size */
         if (t < t2) {
-          logfac11 = h_expo*bi::log(e2max);
+          logfac11 = cfg.expo*bi::log(e2max);
           if (e2max > BI_REAL(1.0)) {
             /* step was rejected */
-            h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
+            h *= bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11));
           } else {
             /* step was accepted */
-            fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11); // Lund-stabilization
-            fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
+            fac = bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11); // Lund-stabilization
+            fac = bi::min(cfg.facr, bi::max(cfg.facl, fac)); // bound
             h *= fac;
             logfacold = BI_REAL(0.5)*bi::log(bi::max(e2max, BI_REAL(1.0e-8)));
           }
@@ -140,4 +163,93 @@ void bi::RK43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
   }
 }
 
+template<class B, class S, class T1>
+void bi::RK43IntegratorSSE<B,S,T1>::updateComponentwise(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  typedef host_vector_reference<sse_real> vector_reference_type;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef RK43VisitorHost<B,S,S,sse_real,PX,sse_real> Visitor;
+  static const int N = block_size<S>::value;
+  const int P = s.size();
+
+  #pragma omp parallel
+  {
+    sse_real buf[4*N]; // use of dynamic array faster than heap allocation
+    vector_reference_type r1(buf, N);
+    vector_reference_type r2(buf + N, N);
+    vector_reference_type err(buf + 2*N, N);
+    vector_reference_type old(buf + 3*N, N);
+
+    sse_real e, e2, t, h, n, logfacold, logfac11, fac, active, accept;
+    int id, p;
+    PX pax;
+
+    #pragma omp for
+    for (p = 0; p < P; p += BI_SSE_SIZE) {
+      t = t1;
+      h = cfg.h0;
+      logfacold = bi::log(BI_REAL(1.0e-4));
+      n = BI_REAL(0.0);
+      active = t < t2;
+      sse_host_load<B,S>(s, p, old);
+      r1 = old;
+
+      /* integrate */
+      while (sse_any(active)) {
+        /* step no further than t2, and not at all once finished */
+        h = sse_if(t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0), t2 - t, h);
+        h = sse_if(active, h, BI_REAL(0.0));
+
+        /* stages */
+        Visitor::stage1(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+        sse_host_store<B,S>(s, p, r1);
+
+        Visitor::stage2(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+        sse_host_store<B,S>(s, p, r2);
+
+        Visitor::stage3(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+        sse_host_store<B,S>(s, p, r1);
+
+        Visitor::stage4(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+        sse_host_store<B,S>(s, p, r2);
+
+        Visitor::stage5(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+        sse_host_store<B,S>(s, p, r1);
+
+        /* determine error of each trajectory */
+        e2 = BI_REAL(0.0);
+        for (id = 0; id < N; ++id) {
+          e = err(id)*h/(bi::max(bi::abs(old(id)), bi::abs(r1(id)))*cfg.rtoler + cfg.atoler);
+          e2 += e*e;
+        }
+        e2 /= N;
+
+        /* accept or reject each trajectory */
+        accept = sse_and(active, e2 <= BI_REAL(1.0));
+        t = sse_if(accept, t + h, t);
+        for (id = 0; id < N; ++id) {
+          old(id) = sse_if(accept, r1(id), old(id));
+        }
+        if (!sse_all(accept)) {
+          r1 = old;
+          sse_host_store<B,S>(s, p, old);
+        }
+
+        /* compute next step size */
+        logfac11 = cfg.expo*bi::log(e2);
+        fac = bi::exp(cfg.beta*logfacold + cfg.logsafe - logfac11); // Lund-stabilization
+        fac = bi::min(cfg.facr, bi::max(cfg.facl, fac)); // bound
+        h = sse_if(accept, h*fac, h*bi::max(cfg.facl, bi::exp(cfg.logsafe - logfac11)));
+        logfacold = sse_if(accept, BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8))), logfacold);
+
+        n = sse_if(active, n + BI_REAL(1.0), n);
+        active = sse_and(t < t2, n < BI_REAL(cfg.nsteps));
+      }
+    }
+  }
+}
+
 #endif
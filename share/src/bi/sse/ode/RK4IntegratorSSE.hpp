@@ -8,6 +8,8 @@
 #ifndef BI_SSE_ODE_RK4INTEGRATORSSE_HPP
 #define BI_SSE_ODE_RK4INTEGRATORSSE_HPP
 
+#include "../../ode/IntegratorConfig.hpp"
+
 namespace bi {
 /**
  * @copydoc RK4Integrator
@@ -18,7 +20,8 @@ public:
   /**
    * @copydoc RK4Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const IntegratorConfig& cfg, const T1 t1,
+      const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
@@ -26,14 +29,13 @@ public:
 #include "../math/function.hpp"
 #include "../math/control.hpp"
 #include "../../host/ode/RK4VisitorHost.hpp"
-#include "../../host/ode/IntegratorConstants.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
 
 template<class B, class S, class T1>
-void bi::RK4IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+void bi::RK4IntegratorSSE<B,S,T1>::update(const IntegratorConfig& cfg,
+    const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
@@ -59,11 +61,11 @@ void bi::RK4IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
     #pragma omp for
     for (p = 0; p < P; p += BI_SSE_SIZE) {
       t = t1;
-      h = h_h0;
+      h = cfg.h0;
 
       /* integrate */
       while (t < t2) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*cfg.uround) {
           // step size too small
         }
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
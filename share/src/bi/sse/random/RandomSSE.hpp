@@ -0,0 +1,60 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_RANDOM_RANDOMSSE_HPP
+#define BI_SSE_RANDOM_RANDOMSSE_HPP
+
+#include "../math/scalar.hpp"
+
+namespace bi {
+/**
+ * Batched transforms of random variates using Streaming SIMD Extensions
+ * (SSE).
+ *
+ * @ingroup math_rng
+ */
+struct RandomSSE {
+  /**
+   * Box-Muller transform of uniform to Gaussian variates.
+   *
+   * @param u Uniform variates on (0,1).
+   * @param[out] z Standard Gaussian variates.
+   * @param n Number of variates.
+   *
+   * Variates <tt>u[k]</tt> and <tt>u[n/2 + k]</tt> give <tt>z[k]</tt> and
+   * <tt>z[n/2 + k]</tt>. @p n must be a multiple of <tt>2*BI_SSE_SIZE</tt>,
+   * and @p u and @p z aligned to #BI_SSE_ALIGN bytes. @p u and @p z may be
+   * the same.
+   */
+  static void boxMuller(const real* u, real* z, const int n);
+};
+}
+
+#include "../../math/function.hpp"
+#include "../math/function.hpp"
+#include "../../math/pi.hpp"
+#include "../../misc/assert.hpp"
+
+inline void bi::RandomSSE::boxMuller(const real* u, real* z, const int n) {
+  /* pre-condition */
+  BI_ASSERT(n % (2*BI_SSE_SIZE) == 0);
+
+  const int m = n/2;
+  sse_real u1, u2, r, a;
+  int k;
+
+  for (k = 0; k < m; k += BI_SSE_SIZE) {
+    u1.packed = BI_SSE_LOAD_P(u + k);
+    u2.packed = BI_SSE_LOAD_P(u + m + k);
+    r = bi::sqrt(BI_REAL(-2.0)*bi::log(u1));
+    a = BI_REAL(BI_TWO_PI)*u2;
+    BI_SSE_STORE_P(z + k, (r*bi::cos(a)).packed);
+    BI_SSE_STORE_P(z + m + k, (r*bi::sin(a)).packed);
+  }
+}
+
+#endif
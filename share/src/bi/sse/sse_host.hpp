@@ -192,8 +192,143 @@ void sse_host_load(State<B,ON_HOST>& s, const int p, V1 x);
 template<class B, class S, class V1>
 void sse_host_store(State<B,ON_HOST>& s, const int p, const V1 x);
 
+/**
+ * Partition active range of state for SSE processing.
+ *
+ * @tparam B Model type.
+ *
+ * @param s State.
+ * @param[out] head Number of trajectories at the start of the range that
+ * precede the first aligned to an sse_real.
+ * @param[out] body Number of trajectories following these that fill whole
+ * sse_real values.
+ *
+ * SSE code may be used for the body, while the head, and the tail of
+ * <tt>s.size() - head - body</tt> trajectories that follows the body,
+ * must use host code.
+ */
+template<class B>
+void sse_host_partition(const State<B,ON_HOST>& s, int& head, int& body);
+
+/**
+ * Update active range of state, using SSE code where possible.
+ *
+ * @tparam H Host updater type, with static <tt>update()</tt>.
+ * @tparam E SSE updater type, with static <tt>update()</tt>.
+ * @tparam B Model type.
+ *
+ * @param[in,out] s State.
+ *
+ * The range is partitioned with sse_host_partition(), the body updated with
+ * <tt>E::update(s)</tt>, and the head and tail with <tt>H::update(s)</tt>.
+ * The active range of @p s is restored on return.
+ */
+template<class H, class E, class B>
+void sse_host_update(State<B,ON_HOST>& s);
+
+/**
+ * As sse_host_update(State<B,ON_HOST>&), passing @p a1 and @p a2 to
+ * <tt>update()</tt> before @p s.
+ */
+template<class H, class E, class A1, class A2, class B>
+void sse_host_update(const A1& a1, const A2& a2, State<B,ON_HOST>& s);
+
+/**
+ * As sse_host_update(State<B,ON_HOST>&), passing @p a1, @p a2 and @p a3 to
+ * <tt>update()</tt> before @p s.
+ */
+template<class H, class E, class A1, class A2, class A3, class B>
+void sse_host_update(const A1& a1, const A2& a2, const A3& a3,
+    State<B,ON_HOST>& s);
+
+/**
+ * @internal
+ *
+ * Apply functor to the head, body and tail of active range of state, as for
+ * sse_host_update().
+ *
+ * @tparam B Model type.
+ * @tparam F Functor type, with <tt>host(s)</tt> and <tt>sse(s)</tt>.
+ *
+ * @param[in,out] s State.
+ * @param f Functor.
+ */
+template<class B, class F>
+void sse_host_apply(State<B,ON_HOST>& s, const F& f);
+
+/**
+ * @internal
+ *
+ * Functor for sse_host_update().
+ */
+template<class H, class E>
+struct sse_host_updater0 {
+  template<class B>
+  void host(State<B,ON_HOST>& s) const {
+    H::update(s);
+  }
+
+  template<class B>
+  void sse(State<B,ON_HOST>& s) const {
+    E::update(s);
+  }
+};
+
+/**
+ * @internal
+ *
+ * Functor for sse_host_update().
+ */
+template<class H, class E, class A1, class A2>
+struct sse_host_updater2 {
+  sse_host_updater2(const A1& a1, const A2& a2) : a1(a1), a2(a2) {
+    //
+  }
+
+  template<class B>
+  void host(State<B,ON_HOST>& s) const {
+    H::update(a1, a2, s);
+  }
+
+  template<class B>
+  void sse(State<B,ON_HOST>& s) const {
+    E::update(a1, a2, s);
+  }
+
+  const A1& a1;
+  const A2& a2;
+};
+
+/**
+ * @internal
+ *
+ * Functor for sse_host_update().
+ */
+template<class H, class E, class A1, class A2, class A3>
+struct sse_host_updater3 {
+  sse_host_updater3(const A1& a1, const A2& a2, const A3& a3) : a1(a1),
+      a2(a2), a3(a3) {
+    //
+  }
+
+  template<class B>
+  void host(State<B,ON_HOST>& s) const {
+    H::update(a1, a2, a3, s);
+  }
+
+  template<class B>
+  void sse(State<B,ON_HOST>& s) const {
+    E::update(a1, a2, a3, s);
+  }
+
+  const A1& a1;
+  const A2& a2;
+  const A3& a3;
+};
+
 }
 
+#include "../math/function.hpp"
 #include "sse_host_load_visitor.hpp"
 #include "sse_host_store_visitor.hpp"
 
@@ -277,4 +412,49 @@ inline void bi::sse_host_store(State<B,ON_HOST>& s, const int p, const V1 x) {
   sse_host_store_visitor<B,S,S>::accept(s, p, x);
 }
 
+template<class B>
+inline void bi::sse_host_partition(const State<B,ON_HOST>& s, int& head,
+    int& body) {
+  head = bi::min(s.size(), (BI_SSE_SIZE - s.start() % BI_SSE_SIZE) %
+      BI_SSE_SIZE);
+  body = ((s.size() - head)/BI_SSE_SIZE)*BI_SSE_SIZE;
+}
+
+template<class B, class F>
+inline void bi::sse_host_apply(State<B,ON_HOST>& s, const F& f) {
+  const int p = s.start(), P = s.size();
+  int head, body;
+  sse_host_partition(s, head, body);
+  if (head > 0) {
+    s.setRange(p, head);
+    f.host(s);
+  }
+  if (body > 0) {
+    s.setRange(p + head, body);
+    f.sse(s);
+  }
+  if (head + body < P) {
+    s.setRange(p + head + body, P - head - body);
+    f.host(s);
+  }
+  s.setRange(p, P);
+}
+
+template<class H, class E, class B>
+inline void bi::sse_host_update(State<B,ON_HOST>& s) {
+  sse_host_apply(s, sse_host_updater0<H,E>());
+}
+
+template<class H, class E, class A1, class A2, class B>
+inline void bi::sse_host_update(const A1& a1, const A2& a2,
+    State<B,ON_HOST>& s) {
+  sse_host_apply(s, sse_host_updater2<H,E,A1,A2>(a1, a2));
+}
+
+template<class H, class E, class A1, class A2, class A3, class B>
+inline void bi::sse_host_update(const A1& a1, const A2& a2, const A3& a3,
+    State<B,ON_HOST>& s) {
+  sse_host_apply(s, sse_host_updater3<H,E,A1,A2,A3>(a1, a2, a3));
+}
+
 #endif
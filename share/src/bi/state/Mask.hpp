@@ -59,6 +59,23 @@ public:
   template<Location L2>
   Mask(const Mask<L2>& o);
 
+  /**
+   * View constructor.
+   *
+   * @tparam M1 Integer matrix type, on host.
+   * @tparam V1 Integer vector type, on host.
+   *
+   * @param info Information on variables in the layout of another mask:
+   * three rows, giving, for each variable, its size if dense, its size if
+   * sparse, and the start of its indices in @p ixs.
+   * @param ixs Indices of sparse variables.
+   *
+   * On host, the mask is a view of @p info and @p ixs, which should
+   * outlive it and not be modified through it.
+   */
+  template<class M1, class V1>
+  Mask(const M1 info, const V1 ixs);
+
   /**
    * Destructor.
    */
@@ -226,6 +243,19 @@ bi::Mask<L>::Mask(const Mask<L2>& o) {
   operator=(o);
 }
 
+template<bi::Location L>
+template<class M1, class V1>
+bi::Mask<L>::Mask(const M1 info, const V1 ixs) : info(info), ixs(ixs),
+    denseSize(0), sparseSize(ixs.size()) {
+  /* pre-conditions */
+  BI_ASSERT(info.size1() == 3);
+  BI_ASSERT(!M1::on_device);
+
+  for (int id = 0; id < info.size2(); ++id) {
+    denseSize += info(0, id);
+  }
+}
+
 template<bi::Location L>
 bi::Mask<L>::~Mask() {
   //
@@ -72,9 +72,11 @@ public:
    * @param p The starting index.
    * @param P The number of trajectories.
    *
-   * It is required that <tt>p == roundup(p)</tt> and
+   * On device, it is required that <tt>p == roundup(p)</tt> and
    * <tt>P == roundup(P)</tt> to ensure correct memory alignment. See
-   * #roundup.
+   * #roundup. On host, any range may be used; SSE code processes
+   * trajectories that are not aligned with host code instead, see
+   * sse_host_partition().
    */
   CUDA_FUNC_BOTH
   void setRange(const int p, const int P);
@@ -130,6 +132,15 @@ public:
    */
   void clear();
 
+  /**
+   * Swap the contents of the state with that of another.
+   *
+   * @param o State.
+   *
+   * Buffers are exchanged rather than copied, so that this is constant time.
+   */
+  void swap(State<B,L>& o);
+
   /**
    * Get buffer for net.
    *
@@ -357,6 +368,8 @@ private:
 
 #include "boost/typeof/typeof.hpp"
 
+#include <algorithm>
+
 template<class B, bi::Location L>
 bi::State<B,L>::State(const int P) :
     Xdn(roundup(P), NR + ND + NO + NDX + NR + ND),  // includes dy- and ry-vars
@@ -391,8 +404,8 @@ bi::State<B,L>& bi::State<B,L>::operator=(const State<B,L2>& o) {
 template<class B, bi::Location L>
 inline void bi::State<B,L>::setRange(const int p, const int P) {
   /* pre-condition */
-  BI_ASSERT(p >= 0 && p == roundup(p));
-  BI_ASSERT(P >= 0 && P == roundup(P));
+  BI_ASSERT(p >= 0 && (L == ON_HOST || p == roundup(p)));
+  BI_ASSERT(P >= 0 && (L == ON_HOST || P == roundup(P)));
 
   if (p + P > sizeMax()) {
     resizeMax(p + P, true);
@@ -456,6 +469,14 @@ inline void bi::State<B,L>::clear() {
   Kdn.clear();
 }
 
+template<class B, bi::Location L>
+inline void bi::State<B,L>::swap(State<B,L>& o) {
+  Xdn.swap(o.Xdn);
+  Kdn.swap(o.Kdn);
+  std::swap(p, o.p);
+  std::swap(P, o.P);
+}
+
 template<class B, bi::Location L>
 inline typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::get(
     const VarType type) {
@@ -743,8 +764,8 @@ int bi::State<B,L>::roundup(const int P) {
     }
   } else {
 #ifdef ENABLE_SSE
-    /* zero, one or a multiple of 4 (single precision) or 2 (double
-     * precision) required */
+    /* zero, one or a multiple of the number of elements in an sse_real
+     * required */
     if (P1 > 1) {
       P1 = ((P1 + BI_SSE_SIZE - 1)/BI_SSE_SIZE)*BI_SSE_SIZE;
     }
@@ -49,6 +49,16 @@ public:
    */
   ThetaParticle& operator=(const ThetaParticle<B,L>& o);
 
+  /**
+   * Swap the contents of the \f$\theta\f$-particle with that of another.
+   *
+   * @param o \f$\theta\f$-particle.
+   *
+   * Buffers, including those of the cache, are exchanged rather than
+   * copied, so that this is constant time.
+   */
+  void swap(ThetaParticle<B,L>& o);
+
   /**
    * Incremental log-likelihood.
    */
@@ -149,6 +159,15 @@ bi::ThetaParticle<B,L>& bi::ThetaParticle<B,L>::operator=(
   return *this;
 }
 
+template<class B, bi::Location L>
+void bi::ThetaParticle<B,L>::swap(ThetaParticle<B,L>& o) {
+  ThetaState<B,L>::swap(o);
+  cache.swap(o.cache);
+  lws.swap(o.lws);
+  as.swap(o.as);
+  std::swap(incLogLikelihood, o.incLogLikelihood);
+}
+
 template<class B, bi::Location L>
 real& bi::ThetaParticle<B,L>::getIncLogLikelihood() {
   return incLogLikelihood;
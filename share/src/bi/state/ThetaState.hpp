@@ -53,6 +53,13 @@ public:
    */
   ThetaState& operator=(const ThetaState<B,L>& o);
 
+  /**
+   * Swap the contents of the state with that of another.
+   *
+   * @param o State.
+   */
+  void swap(ThetaState<B,L>& o);
+
   /**
    * Get state sample.
    */
@@ -207,6 +214,20 @@ bi::ThetaState<B,L>& bi::ThetaState<B,L>::operator=(
   return *this;
 }
 
+template<class B, bi::Location L>
+void bi::ThetaState<B,L>::swap(ThetaState<B,L>& o) {
+  State<B,L>::swap(o);
+  X1.swap(o.X1);
+  theta1.swap(o.theta1);
+  theta2.swap(o.theta2);
+  std::swap(logLikelihood, o.logLikelihood);
+  std::swap(logLikelihood2, o.logLikelihood2);
+  std::swap(logPrior, o.logPrior);
+  std::swap(logPrior2, o.logPrior2);
+  std::swap(logProposal1, o.logProposal1);
+  std::swap(logProposal2, o.logProposal2);
+}
+
 template<class B, bi::Location L>
 typename bi::ThetaState<B,L>::matrix_type& bi::ThetaState<B,L>::getTrajectory() {
   return X1;
@@ -8,6 +8,8 @@
 #ifndef BI_UPDATER_SPARSESTATICLOGDENSITY_HPP
 #define BI_UPDATER_SPARSESTATICLOGDENSITY_HPP
 
+#include "../resampler/WeightStats.hpp"
+
 namespace bi {
 /**
  * Static log-density evaluator.
@@ -51,6 +53,24 @@ public:
   static void logDensities(State<B,ON_HOST>& s, const int p,
       const Mask<ON_HOST>& mask, V1 lp);
 
+  /**
+   * Evaluate log-density and reduce.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param[in,out] s State.
+   * @param mask Sparsity mask.
+   * @param[in,out] lp Log-density.
+   *
+   * @return Statistics of @p lp, after the update, from which its
+   * log-sum-exp and ESS follow.
+   *
+   * The log density is <i>added to</i> @p lp, as for logDensities().
+   */
+  template<class V1>
+  static WeightStats logSumExpDensities(State<B,ON_HOST>& s,
+      const Mask<ON_HOST>& mask, V1 lp);
+
   #ifdef __CUDACC__
   /**
    * Evaluate log-density.
@@ -82,6 +102,24 @@ public:
   template<class V1>
   static void logDensities(State<B,ON_DEVICE>& s, const int p,
       const Mask<ON_DEVICE>& mask, V1 lp);
+
+  /**
+   * Evaluate log-density and reduce.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param[in,out] s State.
+   * @param mask Sparsity mask.
+   * @param[in,out] lp Log-density.
+   *
+   * @return Statistics of @p lp, after the update, from which its
+   * log-sum-exp and ESS follow.
+   *
+   * The log density is <i>added to</i> @p lp, as for logDensities().
+   */
+  template<class V1>
+  static WeightStats logSumExpDensities(State<B,ON_DEVICE>& s,
+      const Mask<ON_DEVICE>& mask, V1 lp);
   #endif
 };
 }
@@ -117,6 +155,13 @@ void bi::SparseStaticLogDensity<B,S>::logDensities(State<B,ON_HOST>& s,
   SparseStaticLogDensityHost<B,S>::logDensities(s, p, mask, lp);
 }
 
+template<class B, class S>
+template<class V1>
+bi::WeightStats bi::SparseStaticLogDensity<B,S>::logSumExpDensities(
+    State<B,ON_HOST>& s, const Mask<ON_HOST>& mask, V1 lp) {
+  return SparseStaticLogDensityHost<B,S>::logSumExpDensities(s, mask, lp);
+}
+
 #ifdef __CUDACC__
 template<class B, class S>
 template<class V1>
@@ -131,6 +176,18 @@ void bi::SparseStaticLogDensity<B,S>::logDensities(State<B,ON_DEVICE>& s,
     const int p, const Mask<ON_DEVICE>& mask, V1 lp) {
   SparseStaticLogDensityGPU<B,S>::logDensities(s, p, mask, lp);
 }
+
+template<class B, class S>
+template<class V1>
+bi::WeightStats bi::SparseStaticLogDensity<B,S>::logSumExpDensities(
+    State<B,ON_DEVICE>& s, const Mask<ON_DEVICE>& mask, V1 lp) {
+  WeightStats ws;
+
+  SparseStaticLogDensityGPU<B,S>::logDensities(s, mask, lp);
+  ws.update(lp);
+
+  return ws;
+}
 #endif
 
 #endif
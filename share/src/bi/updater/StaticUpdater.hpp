@@ -66,11 +66,7 @@ public:
 template<class B, class S>
 void bi::StaticUpdater<B,S>::update(State<B,ON_HOST>& s) {
   #ifdef ENABLE_SSE
-  if (s.size() % BI_SSE_SIZE == 0) {
-    StaticUpdaterSSE<B,S>::update(s);
-  } else {
-    StaticUpdaterHost<B,S>::update(s);
-  }
+  sse_host_update<StaticUpdaterHost<B,S>,StaticUpdaterSSE<B,S> >(s);
   #else
   StaticUpdaterHost<B,S>::update(s);
   #endif